@@ -0,0 +1,34 @@
+// timing helpers for the standalone benchmarks
+
+#pragma once
+#include <chrono>
+#include <stdio.h>
+
+// keeps results alive so the optimizer can't drop the work
+static volatile float benchSink;
+
+// stops the compiler from hoisting work out of repeat loops
+inline void benchBarrier() {
+	__asm__ __volatile__("" ::: "memory");
+}
+
+// one run of f(), which does `count` units of work, in nanoseconds per unit
+template <class F>
+double benchTime(F f, long count) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+// best of several runs
+template <class F>
+double benchmark(F f, long count, int runs = 5) {
+	double best = 1e30;
+	for (int r = 0; r < runs; r++) {
+		double ns = benchTime(f, count);
+		if (ns < best)
+			best = ns;
+	}
+	return best;
+}
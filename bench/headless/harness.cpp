@@ -0,0 +1,226 @@
+// runs the plugin's modules outside rack: every input is plugged and fed a
+// slow sine per channel, every output is plugged, and process() runs for the
+// requested stretch of audio. prints throughput and per-output statistics as
+// csv, or json with --json. with --instances, several copies of each module
+// run side by side, timed together, with the statistics of the first. build
+// with -g and run under perf to profile the real per-module path, port reads
+// and writes included
+
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+#include "attractor-lfo.hpp"
+
+void init(Plugin *p);
+
+static const int CHUNK = 256; // samples between clock reads, inputs are prepared per chunk
+
+struct Options {
+	float sampleRate = 48000.f;
+	float seconds = 10.f;
+	int channels = 1;
+	bool json = false;
+	bool normalize = false;
+	bool share = false;
+	bool prerender = false; // paced at real time so the worker can keep up
+	int instances = 1;
+	std::vector<std::string> slugs;
+};
+
+struct OutputStats {
+	std::string name;
+	int channels = 0;
+	double min = INFINITY, max = -INFINITY, sum = 0.0, sumSquares = 0.0;
+	long count = 0, nonFinite = 0;
+
+	void add(float v) {
+		if (!std::isfinite(v)) {
+			nonFinite++;
+			return;
+		}
+		min = std::min(min, (double) v);
+		max = std::max(max, (double) v);
+		sum += v;
+		sumSquares += (double) v * v;
+		count++;
+	}
+};
+
+struct Report {
+	std::string slug;
+	double nsPerSample;
+	double cpuPercent; // of one core at the chosen sample rate
+	std::vector<OutputStats> outputs;
+};
+
+Report run(Model *model, const Options &options) {
+	std::vector<Module*> modules;
+	for (int n = 0; n < options.instances; n++) {
+		Module *module = model->createModule();
+		module->onSampleRateChange(Module::SampleRateChangeEvent{options.sampleRate, 1.f / options.sampleRate});
+		if (AttractorLfoBase *lfo = dynamic_cast<AttractorLfoBase*>(module)) {
+			lfo->channels = options.channels;
+			lfo->setNormalize(options.normalize);
+			lfo->setSharing(options.share);
+			lfo->setPrerender(options.prerender);
+		}
+		for (Input &input : module->inputs)
+			input.channels = options.channels;
+		for (Output &output : module->outputs)
+			output.channels = 1;
+		modules.push_back(module);
+	}
+	Module *module = modules[0];
+
+	int numInputs = module->inputs.size();
+	int numOutputs = module->outputs.size();
+
+	Report report;
+	report.slug = model->slug;
+	report.outputs.resize(numOutputs);
+	for (int o = 0; o < numOutputs; o++) {
+		bool named = o < (int) module->outputInfos.size() && module->outputInfos[o];
+		report.outputs[o].name = named ? module->outputInfos[o]->name : string::f("%d", o);
+	}
+
+	// ±5v sines from 0.1 Hz up, a different frequency per input and channel
+	std::vector<float> in(CHUNK * numInputs * PORT_MAX_CHANNELS);
+	std::vector<float> out(CHUNK * numOutputs * PORT_MAX_CHANNELS);
+	std::vector<int> outChannels(CHUNK * numOutputs);
+
+	Module::ProcessArgs args;
+	args.sampleRate = options.sampleRate;
+	args.sampleTime = 1.f / options.sampleRate;
+	args.frame = 0;
+	long samples = (long) (options.seconds * options.sampleRate);
+	double ns = 0.0;
+	auto due = std::chrono::steady_clock::now();
+	for (long start = 0; start < samples; start += CHUNK) {
+		int length = std::min((long) CHUNK, samples - start);
+		for (int s = 0; s < length; s++) {
+			double t = (start + s) * (double) args.sampleTime;
+			for (int i = 0; i < numInputs; i++)
+				for (int c = 0; c < options.channels; c++)
+					in[(s * numInputs + i) * PORT_MAX_CHANNELS + c] = 5.f * sin(2.0 * M_PI * 0.1 * (1 + i + 0.25 * c) * t);
+		}
+
+		auto clockStart = std::chrono::steady_clock::now();
+		for (int s = 0; s < length; s++) {
+			// what the engine's cable step would do before each process()
+			for (Module *m : modules) {
+				for (int i = 0; i < numInputs; i++)
+					memcpy(m->inputs[i].voltages, &in[(s * numInputs + i) * PORT_MAX_CHANNELS], options.channels * sizeof(float));
+				m->process(args);
+			}
+			args.frame++;
+			for (int o = 0; o < numOutputs; o++) {
+				memcpy(&out[(s * numOutputs + o) * PORT_MAX_CHANNELS], module->outputs[o].voltages, sizeof(module->outputs[o].voltages));
+				outChannels[s * numOutputs + o] = module->outputs[o].channels;
+			}
+		}
+		ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - clockStart).count();
+		if (options.prerender) {
+			due += std::chrono::nanoseconds((long) (length * 1e9 / options.sampleRate));
+			std::this_thread::sleep_until(due);
+		}
+
+		for (int s = 0; s < length; s++) {
+			for (int o = 0; o < numOutputs; o++) {
+				OutputStats &stats = report.outputs[o];
+				int channels = outChannels[s * numOutputs + o];
+				stats.channels = std::max(stats.channels, channels);
+				for (int c = 0; c < channels; c++)
+					stats.add(out[(s * numOutputs + o) * PORT_MAX_CHANNELS + c]);
+			}
+		}
+	}
+	// kept off stdout so the csv stays the same. summed over the instances
+	if (options.prerender && dynamic_cast<AttractorLfoBase*>(module)) {
+		unsigned long underruns = 0;
+		for (Module *m : modules)
+			underruns += dynamic_cast<AttractorLfoBase*>(m)->underruns;
+		fprintf(stderr, "%s: %lu blocks not ready in time\n", model->slug.c_str(), underruns);
+	}
+	for (Module *m : modules)
+		delete m;
+
+	report.nsPerSample = ns / std::max(samples, 1L);
+	report.cpuPercent = 100.0 * report.nsPerSample * options.sampleRate * 1e-9;
+	return report;
+}
+
+void print(const std::vector<Report> &reports, const Options &options) {
+	if (options.json)
+		printf("[\n");
+	else
+		printf("module,output,channels,ns_per_sample,cpu_percent,min,max,mean,rms,non_finite\n");
+	bool first = true;
+	for (const Report &report : reports) {
+		// modules without outputs still get a row for their throughput
+		std::vector<OutputStats> outputs = report.outputs;
+		if (outputs.empty())
+			outputs.push_back(OutputStats());
+		for (const OutputStats &stats : outputs) {
+			double mean = stats.count ? stats.sum / stats.count : 0.0;
+			double rms = stats.count ? std::sqrt(stats.sumSquares / stats.count) : 0.0;
+			double min = stats.count ? stats.min : 0.0;
+			double max = stats.count ? stats.max : 0.0;
+			if (options.json) {
+				printf("%s\t{\"module\": \"%s\", \"output\": \"%s\", \"channels\": %d, \"ns_per_sample\": %.2f, \"cpu_percent\": %.4f, "
+					"\"min\": %.4f, \"max\": %.4f, \"mean\": %.4f, \"rms\": %.4f, \"non_finite\": %ld}",
+					first ? "" : ",\n", report.slug.c_str(), stats.name.c_str(), stats.channels, report.nsPerSample, report.cpuPercent,
+					min, max, mean, rms, stats.nonFinite);
+			}
+			else {
+				printf("%s,%s,%d,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f,%ld\n",
+					report.slug.c_str(), stats.name.c_str(), stats.channels, report.nsPerSample, report.cpuPercent,
+					min, max, mean, rms, stats.nonFinite);
+			}
+			first = false;
+		}
+	}
+	if (options.json)
+		printf("\n]\n");
+}
+
+int main(int argc, char **argv) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--rate" && i + 1 < argc)
+			options.sampleRate = atof(argv[++i]);
+		else if (arg == "--seconds" && i + 1 < argc)
+			options.seconds = atof(argv[++i]);
+		else if (arg == "--channels" && i + 1 < argc)
+			options.channels = clamp(atoi(argv[++i]), 1, PORT_MAX_CHANNELS);
+		else if (arg == "--json")
+			options.json = true;
+		else if (arg == "--normalize")
+			options.normalize = true;
+		else if (arg == "--instances" && i + 1 < argc)
+			options.instances = std::max(atoi(argv[++i]), 1);
+		else if (arg == "--share")
+			options.share = true;
+		else if (arg == "--prerender")
+			options.prerender = true;
+		else if (arg.size() > 0 && arg[0] == '-') {
+			fprintf(stderr, "usage: %s [--rate hz] [--seconds s] [--channels n] [--normalize] [--instances n] [--share] [--prerender] [--json] [module slug...]\n", argv[0]);
+			return 1;
+		}
+		else
+			options.slugs.push_back(arg);
+	}
+
+	Plugin plugin;
+	pluginInstance = &plugin;
+	init(&plugin);
+
+	std::vector<Report> reports;
+	for (Model *model : plugin.models) {
+		if (!options.slugs.empty() && std::find(options.slugs.begin(), options.slugs.end(), model->slug) == options.slugs.end())
+			continue;
+		reports.push_back(run(model, options));
+	}
+	print(reports, options);
+	return 0;
+}
@@ -0,0 +1,153 @@
+// definitions for rack.hpp: json, drawing and menus do nothing, assets are
+// looked up in the plugin directory given at build time
+
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <rack.hpp>
+
+#ifndef HEADLESS_PLUGIN_DIR
+	#define HEADLESS_PLUGIN_DIR "."
+#endif
+
+json_t *json_object() { return nullptr; }
+json_t *json_integer(long long value) { return nullptr; }
+json_t *json_real(double value) { return nullptr; }
+json_t *json_boolean(bool value) { return nullptr; }
+int json_object_set_new(json_t *object, const char *key, json_t *value) { return 0; }
+json_t *json_object_get(const json_t *object, const char *key) { return nullptr; }
+long long json_integer_value(const json_t *json) { return 0; }
+double json_number_value(const json_t *json) { return 0.0; }
+bool json_boolean_value(const json_t *json) { return false; }
+
+NVGcolor nvgRGB(unsigned char r, unsigned char g, unsigned char b) { return nvgRGBA(r, g, b, 255); }
+NVGcolor nvgRGBA(unsigned char r, unsigned char g, unsigned char b, unsigned char a) { return NVGcolor{r / 255.f, g / 255.f, b / 255.f, a / 255.f}; }
+NVGcolor nvgHSLA(float h, float s, float l, unsigned char a) { return NVGcolor{l, l, l, a / 255.f}; }
+void nvgSave(NVGcontext *ctx) {}
+void nvgRestore(NVGcontext *ctx) {}
+void nvgBeginPath(NVGcontext *ctx) {}
+void nvgRect(NVGcontext *ctx, float x, float y, float w, float h) {}
+void nvgMoveTo(NVGcontext *ctx, float x, float y) {}
+void nvgLineTo(NVGcontext *ctx, float x, float y) {}
+void nvgFill(NVGcontext *ctx) {}
+void nvgStroke(NVGcontext *ctx) {}
+void nvgFillColor(NVGcontext *ctx, NVGcolor color) {}
+void nvgStrokeColor(NVGcontext *ctx, NVGcolor color) {}
+void nvgStrokeWidth(NVGcontext *ctx, float size) {}
+void nvgLineCap(NVGcontext *ctx, int cap) {}
+void nvgMiterLimit(NVGcontext *ctx, float limit) {}
+void nvgGlobalCompositeOperation(NVGcontext *ctx, int op) {}
+void nvgScissor(NVGcontext *ctx, float x, float y, float w, float h) {}
+void nvgResetScissor(NVGcontext *ctx) {}
+void nvgTranslate(NVGcontext *ctx, float x, float y) {}
+void nvgRotate(NVGcontext *ctx, float angle) {}
+int nvgCreateImageRGBA(NVGcontext *ctx, int w, int h, int imageFlags, const unsigned char *data) { return 1; }
+void nvgUpdateImage(NVGcontext *ctx, int image, const unsigned char *data) {}
+void nvgDeleteImage(NVGcontext *ctx, int image) {}
+NVGpaint nvgImagePattern(NVGcontext *ctx, float ox, float oy, float ex, float ey, float angle, int image, float alpha) { return NVGpaint(); }
+void nvgFillPaint(NVGcontext *ctx, NVGpaint paint) {}
+void nvgFontSize(NVGcontext *ctx, float size) {}
+void nvgFontFaceId(NVGcontext *ctx, int font) {}
+void nvgTextLetterSpacing(NVGcontext *ctx, float spacing) {}
+float nvgText(NVGcontext *ctx, float x, float y, const char *string, const char *end) { return x; }
+
+namespace rack {
+
+std::string string::f(const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	char buffer[1024];
+	vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	return buffer;
+}
+
+std::u16string string::UTF8toUTF16(const std::string &s) {
+	return std::u16string(s.begin(), s.end());
+}
+
+std::string asset::plugin(Plugin *plugin, const std::string &filename) {
+	return std::string(HEADLESS_PLUGIN_DIR) + "/" + filename;
+}
+
+// recordings and other user files go to a scratch folder
+std::string asset::user(const std::string &filename) {
+	return "/tmp/headless-rack-user/" + filename;
+}
+
+std::string system::join(const std::string &path1, const std::string &path2) {
+	return path1 + "/" + path2;
+}
+
+void system::createDirectories(const std::string &path) {
+	for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+		mkdir(path.substr(0, slash).c_str(), 0755);
+		if (slash == std::string::npos)
+			break;
+	}
+}
+
+bool system::exists(const std::string &path) {
+	struct stat st;
+	return stat(path.c_str(), &st) == 0;
+}
+
+// plain radix 2, only for checking results
+void dsp::RealFFT::rfft(const float *input, float *output) {
+	size_t n = length;
+	std::vector<double> re(input, input + n), im(n, 0.0);
+	for (size_t i = 1, j = 0; i < n; i++) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j) {
+			std::swap(re[i], re[j]);
+			std::swap(im[i], im[j]);
+		}
+	}
+	for (size_t len = 2; len <= n; len <<= 1) {
+		double angle = -2 * M_PI / len;
+		for (size_t i = 0; i < n; i += len) {
+			for (size_t k = 0; k < len / 2; k++) {
+				double wr = cos(angle * k), wi = sin(angle * k);
+				size_t a = i + k, b = i + k + len / 2;
+				double tr = re[b] * wr - im[b] * wi, ti = re[b] * wi + im[b] * wr;
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+	output[0] = re[0];
+	output[1] = re[n / 2];
+	for (size_t k = 1; k < n / 2; k++) {
+		output[2 * k] = re[k];
+		output[2 * k + 1] = im[k];
+	}
+}
+
+std::shared_ptr<Svg> window::Window::loadSvg(const std::string &filename) { return nullptr; }
+std::shared_ptr<Font> window::Window::loadFont(const std::string &filename) { return nullptr; }
+
+math::Vec app::RackWidget::getMousePos() { return math::Vec(); }
+bool app::RackWidget::requestModulePos(Widget *w, math::Vec pos) { return true; }
+
+Context *contextGet() {
+	static engine::Engine engine;
+	static window::Window window;
+	static app::Scene scene;
+	static Context context;
+	context.engine = &engine;
+	context.window = &window;
+	context.scene = &scene;
+	return &context;
+}
+
+Widget *createPanel(const std::string &svgPath) { return new Widget; }
+MenuItem *createMenuLabel(const std::string &text) { return new MenuItem; }
+MenuItem *createMenuItem(const std::string &text, const std::string &rightText, std::function<void()> action, bool disabled) { return new MenuItem; }
+MenuItem *createBoolMenuItem(const std::string &text, const std::string &rightText, std::function<bool()> getter, std::function<void(bool)> setter, bool disabled) { return new MenuItem; }
+MenuItem *createIndexSubmenuItem(const std::string &text, std::vector<std::string> labels, std::function<size_t()> getter, std::function<void(size_t)> setter, bool disabled) { return new MenuItem; }
+
+} // namespace rack
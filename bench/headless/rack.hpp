@@ -0,0 +1,602 @@
+// headless stand-in for the parts of the rack v2 sdk this plugin uses, so
+// modules run outside rack. the engine side (Module, Param, Port, Light,
+// ProcessArgs, simd, dsp) behaves like rack's. the ui side only has to compile
+// and link: the harness never creates widgets, and drawing, menus and json
+// do nothing
+
+#pragma once
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <smmintrin.h>
+
+////////// jansson //////////
+
+typedef struct json_t json_t;
+json_t *json_object();
+json_t *json_integer(long long value);
+json_t *json_real(double value);
+json_t *json_boolean(bool value);
+int json_object_set_new(json_t *object, const char *key, json_t *value);
+json_t *json_object_get(const json_t *object, const char *key);
+long long json_integer_value(const json_t *json);
+double json_number_value(const json_t *json);
+bool json_boolean_value(const json_t *json);
+
+////////// nanovg //////////
+
+struct NVGcontext;
+struct NVGcolor { float r, g, b, a; };
+struct NVGpaint { float xform[6]; float extent[2]; float radius, feather; NVGcolor innerColor, outerColor; int image; };
+enum NVGimageFlags { NVG_IMAGE_NEAREST = 1 << 5 };
+enum NVGlineCap { NVG_ROUND = 1 };
+enum NVGcompositeOperation { NVG_LIGHTER = 6 };
+
+NVGcolor nvgRGB(unsigned char r, unsigned char g, unsigned char b);
+NVGcolor nvgRGBA(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+NVGcolor nvgHSLA(float h, float s, float l, unsigned char a);
+void nvgSave(NVGcontext *ctx);
+void nvgRestore(NVGcontext *ctx);
+void nvgBeginPath(NVGcontext *ctx);
+void nvgRect(NVGcontext *ctx, float x, float y, float w, float h);
+void nvgMoveTo(NVGcontext *ctx, float x, float y);
+void nvgLineTo(NVGcontext *ctx, float x, float y);
+void nvgFill(NVGcontext *ctx);
+void nvgStroke(NVGcontext *ctx);
+void nvgFillColor(NVGcontext *ctx, NVGcolor color);
+void nvgStrokeColor(NVGcontext *ctx, NVGcolor color);
+void nvgStrokeWidth(NVGcontext *ctx, float size);
+void nvgLineCap(NVGcontext *ctx, int cap);
+void nvgMiterLimit(NVGcontext *ctx, float limit);
+void nvgGlobalCompositeOperation(NVGcontext *ctx, int op);
+void nvgScissor(NVGcontext *ctx, float x, float y, float w, float h);
+void nvgResetScissor(NVGcontext *ctx);
+void nvgTranslate(NVGcontext *ctx, float x, float y);
+void nvgRotate(NVGcontext *ctx, float angle);
+int nvgCreateImageRGBA(NVGcontext *ctx, int w, int h, int imageFlags, const unsigned char *data);
+void nvgUpdateImage(NVGcontext *ctx, int image, const unsigned char *data);
+void nvgDeleteImage(NVGcontext *ctx, int image);
+NVGpaint nvgImagePattern(NVGcontext *ctx, float ox, float oy, float ex, float ey, float angle, int image, float alpha);
+void nvgFillPaint(NVGcontext *ctx, NVGpaint paint);
+void nvgFontSize(NVGcontext *ctx, float size);
+void nvgFontFaceId(NVGcontext *ctx, int font);
+void nvgTextLetterSpacing(NVGcontext *ctx, float spacing);
+float nvgText(NVGcontext *ctx, float x, float y, const char *string, const char *end);
+
+enum { GLFW_MOUSE_BUTTON_LEFT = 0 };
+enum { GLFW_MOD_SHIFT = 1, GLFW_MOD_CONTROL = 2, GLFW_MOD_ALT = 4, GLFW_MOD_SUPER = 8 };
+#define RACK_MOD_MASK (GLFW_MOD_SHIFT | GLFW_MOD_CONTROL | GLFW_MOD_ALT | GLFW_MOD_SUPER)
+
+#define LENGTHOF(arr) (sizeof(arr) / sizeof((arr)[0]))
+#define RACK_GRID_WIDTH 15
+#define RACK_GRID_HEIGHT 380
+
+namespace rack {
+
+////////// math //////////
+
+namespace math {
+
+inline int clamp(int x, int a, int b) { return std::max(std::min(x, b), a); }
+inline float clamp(float x, float a = 0.f, float b = 1.f) { return std::fmax(std::fmin(x, b), a); }
+inline float rescale(float x, float xMin, float xMax, float yMin, float yMax) { return yMin + (x - xMin) / (xMax - xMin) * (yMax - yMin); }
+inline bool isNear(float a, float b, float epsilon = 1e-6f) { return std::fabs(a - b) <= epsilon; }
+inline float crossfade(float a, float b, float p) { return a + (b - a) * p; }
+
+struct Vec {
+	float x = 0.f, y = 0.f;
+	Vec() {}
+	Vec(float x, float y) : x(x), y(y) {}
+	Vec plus(Vec b) const { return Vec(x + b.x, y + b.y); }
+	Vec minus(Vec b) const { return Vec(x - b.x, y - b.y); }
+	Vec mult(float s) const { return Vec(x * s, y * s); }
+};
+
+struct Rect {
+	Vec pos, size;
+	Rect() {}
+	Rect(Vec pos, Vec size) : pos(pos), size(size) {}
+};
+
+} // namespace math
+using namespace math;
+
+////////// simd //////////
+
+namespace simd {
+
+template <typename T, int N>
+struct Vector;
+
+template <>
+struct Vector<float, 4> {
+	union {
+		__m128 v;
+		float s[4];
+	};
+
+	Vector() = default;
+	Vector(__m128 v) : v(v) {}
+	Vector(float x) : v(_mm_set1_ps(x)) {}
+	Vector(float x1, float x2, float x3, float x4) : v(_mm_setr_ps(x1, x2, x3, x4)) {}
+	float &operator[](int i) { return s[i]; }
+	const float &operator[](int i) const { return s[i]; }
+	static Vector load(const float *x) { return Vector(_mm_loadu_ps(x)); }
+	void store(float *x) { _mm_storeu_ps(x, v); }
+	static Vector zero() { return Vector(_mm_setzero_ps()); }
+};
+
+typedef Vector<float, 4> float_4;
+
+template <>
+struct Vector<int32_t, 4> {
+	union {
+		__m128i v;
+		int32_t s[4];
+	};
+
+	Vector() = default;
+	Vector(__m128i v) : v(v) {}
+	Vector(int32_t x) : v(_mm_set1_epi32(x)) {}
+	int32_t &operator[](int i) { return s[i]; }
+	const int32_t &operator[](int i) const { return s[i]; }
+	static Vector load(const int32_t *x) { return Vector(_mm_loadu_si128((const __m128i*) x)); }
+	void store(int32_t *x) { _mm_storeu_si128((__m128i*) x, v); }
+};
+
+typedef Vector<int32_t, 4> int32_4;
+
+inline int32_4 operator+(const int32_4 &a, const int32_4 &b) { return _mm_add_epi32(a.v, b.v); }
+inline int32_4 operator-(const int32_4 &a, const int32_4 &b) { return _mm_sub_epi32(a.v, b.v); }
+inline int32_4 operator<<(const int32_4 &a, const int &b) { return _mm_sll_epi32(a.v, _mm_cvtsi32_si128(b)); }
+inline int32_4 operator>>(const int32_4 &a, const int &b) { return _mm_srl_epi32(a.v, _mm_cvtsi32_si128(b)); }
+
+inline float_4 operator+(const float_4 &a, const float_4 &b) { return _mm_add_ps(a.v, b.v); }
+inline float_4 operator-(const float_4 &a, const float_4 &b) { return _mm_sub_ps(a.v, b.v); }
+inline float_4 operator*(const float_4 &a, const float_4 &b) { return _mm_mul_ps(a.v, b.v); }
+inline float_4 operator/(const float_4 &a, const float_4 &b) { return _mm_div_ps(a.v, b.v); }
+inline float_4 operator-(const float_4 &a) { return _mm_sub_ps(_mm_setzero_ps(), a.v); }
+inline float_4 operator&(const float_4 &a, const float_4 &b) { return _mm_and_ps(a.v, b.v); }
+inline float_4 operator|(const float_4 &a, const float_4 &b) { return _mm_or_ps(a.v, b.v); }
+inline float_4 operator^(const float_4 &a, const float_4 &b) { return _mm_xor_ps(a.v, b.v); }
+inline float_4 &operator+=(float_4 &a, const float_4 &b) { return a = a + b; }
+inline float_4 &operator-=(float_4 &a, const float_4 &b) { return a = a - b; }
+inline float_4 &operator*=(float_4 &a, const float_4 &b) { return a = a * b; }
+inline float_4 &operator/=(float_4 &a, const float_4 &b) { return a = a / b; }
+inline float_4 operator<(const float_4 &a, const float_4 &b) { return _mm_cmplt_ps(a.v, b.v); }
+inline float_4 operator<=(const float_4 &a, const float_4 &b) { return _mm_cmple_ps(a.v, b.v); }
+inline float_4 operator>(const float_4 &a, const float_4 &b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline float_4 operator>=(const float_4 &a, const float_4 &b) { return _mm_cmpge_ps(a.v, b.v); }
+inline float_4 operator==(const float_4 &a, const float_4 &b) { return _mm_cmpeq_ps(a.v, b.v); }
+inline float_4 operator!=(const float_4 &a, const float_4 &b) { return _mm_cmpneq_ps(a.v, b.v); }
+
+inline int movemask(const float_4 &a) { return _mm_movemask_ps(a.v); }
+inline float_4 ifelse(const float_4 &mask, const float_4 &a, const float_4 &b) { return _mm_blendv_ps(b.v, a.v, mask.v); }
+inline float_4 fmin(const float_4 &a, const float_4 &b) { return _mm_min_ps(a.v, b.v); }
+inline float_4 fmax(const float_4 &a, const float_4 &b) { return _mm_max_ps(a.v, b.v); }
+inline float_4 clamp(const float_4 &x, const float_4 &a, const float_4 &b) { return fmin(fmax(x, a), b); }
+inline float_4 fabs(const float_4 &a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a.v); }
+inline float_4 sqrt(const float_4 &a) { return _mm_sqrt_ps(a.v); }
+inline float_4 floor(const float_4 &a) { return _mm_floor_ps(a.v); }
+inline float_4 round(const float_4 &a) { return _mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+} // namespace simd
+
+////////// utilities //////////
+
+namespace string {
+std::string f(const char *format, ...);
+std::u16string UTF8toUTF16(const std::string &s);
+}
+
+#define WARN(format, ...) fprintf(stderr, "[warn] " format "\n", ##__VA_ARGS__)
+#define INFO(format, ...) fprintf(stderr, "[info] " format "\n", ##__VA_ARGS__)
+
+////////// dsp //////////
+
+namespace dsp {
+
+template <typename T = float>
+struct TSchmittTrigger {
+	bool state = true;
+	void reset() { state = true; }
+	bool process(T in, T offThreshold = 0.f, T onThreshold = 1.f) {
+		if (state) {
+			if (in <= offThreshold)
+				state = false;
+		}
+		else if (in >= onThreshold) {
+			state = true;
+			return true;
+		}
+		return false;
+	}
+	bool isHigh() { return state; }
+};
+
+typedef TSchmittTrigger<> SchmittTrigger;
+
+// same output order as rack's pffft based one: the dc and nyquist bins'
+// real parts, then real and imaginary parts of every bin in between
+struct RealFFT {
+	size_t length;
+	RealFFT(size_t length) : length(length) {}
+	void rfft(const float *input, float *output);
+};
+
+} // namespace dsp
+
+////////// engine //////////
+
+struct Model;
+
+namespace engine {
+
+static const int PORT_MAX_CHANNELS = 16;
+
+struct ParamQuantity {
+	std::string name, unit;
+	float minValue = 0.f, maxValue = 1.f, defaultValue = 0.f;
+	bool snapEnabled = false;
+	virtual ~ParamQuantity() {}
+};
+
+struct PortInfo {
+	std::string name;
+};
+
+struct Param {
+	float value = 0.f;
+	float getValue() { return value; }
+	void setValue(float value) { this->value = value; }
+};
+
+struct Port {
+	union {
+		float voltages[PORT_MAX_CHANNELS] = {};
+		float value;
+	};
+	// 0 means unplugged, as in rack
+	uint8_t channels = 0;
+
+	void setVoltage(float voltage, int channel = 0) { voltages[channel] = voltage; }
+	float getVoltage(int channel = 0) { return voltages[channel]; }
+	float getPolyVoltage(int channel) { return isMonophonic() ? getVoltage(0) : getVoltage(channel); }
+	float getNormalVoltage(float normalVoltage, int channel = 0) { return isConnected() ? getVoltage(channel) : normalVoltage; }
+	float getNormalPolyVoltage(float normalVoltage, int channel) { return isConnected() ? getPolyVoltage(channel) : normalVoltage; }
+	float *getVoltages(int firstChannel = 0) { return &voltages[firstChannel]; }
+
+	template <typename T>
+	T getVoltageSimd(int firstChannel) { return T::load(&voltages[firstChannel]); }
+	template <typename T>
+	T getPolyVoltageSimd(int firstChannel) { return isMonophonic() ? T(getVoltage(0)) : getVoltageSimd<T>(firstChannel); }
+	template <typename T>
+	T getNormalPolyVoltageSimd(T normalVoltage, int firstChannel) { return isConnected() ? getPolyVoltageSimd<T>(firstChannel) : normalVoltage; }
+	template <typename T>
+	void setVoltageSimd(T voltage, int firstChannel) { voltage.store(&voltages[firstChannel]); }
+
+	// like rack, only has an effect on connected ports
+	void setChannels(int channels) {
+		if (this->channels == 0)
+			return;
+		for (int c = channels; c < this->channels; c++)
+			voltages[c] = 0.f;
+		this->channels = std::max(channels, 1);
+	}
+	int getChannels() { return channels; }
+	bool isConnected() { return channels > 0; }
+	bool isMonophonic() { return channels == 1; }
+	bool isPolyphonic() { return channels > 1; }
+};
+
+struct Input : Port {};
+struct Output : Port {};
+
+struct Light {
+	float value = 0.f;
+	void setBrightness(float brightness) { value = brightness; }
+};
+
+struct Module {
+	Model *model = nullptr;
+	std::vector<Param> params;
+	std::vector<Input> inputs;
+	std::vector<Output> outputs;
+	std::vector<Light> lights;
+	std::vector<ParamQuantity*> paramQuantities;
+	std::vector<PortInfo*> inputInfos;
+	std::vector<PortInfo*> outputInfos;
+
+	struct ProcessArgs {
+		float sampleRate;
+		float sampleTime;
+		int64_t frame;
+	};
+
+	struct SampleRateChangeEvent {
+		float sampleRate;
+		float sampleTime;
+	};
+
+	struct ResetEvent {};
+
+	// neighbours are linked by hand, nothing places modules side by side
+	struct Expander {
+		Module *module = nullptr;
+	};
+	Expander leftExpander;
+	Expander rightExpander;
+
+	virtual ~Module() {
+		for (ParamQuantity *q : paramQuantities)
+			delete q;
+		for (PortInfo *info : inputInfos)
+			delete info;
+		for (PortInfo *info : outputInfos)
+			delete info;
+	}
+
+	void config(int numParams, int numInputs, int numOutputs, int numLights = 0) {
+		params.resize(numParams);
+		inputs.resize(numInputs);
+		outputs.resize(numOutputs);
+		lights.resize(numLights);
+		paramQuantities.resize(numParams);
+	}
+
+	template <class TParamQuantity = ParamQuantity>
+	TParamQuantity *configParam(int paramId, float minValue, float maxValue, float defaultValue, std::string name = "", std::string unit = "", float displayBase = 0.f, float displayMultiplier = 1.f, float displayOffset = 0.f) {
+		delete paramQuantities[paramId];
+		TParamQuantity *q = new TParamQuantity;
+		q->minValue = minValue;
+		q->maxValue = maxValue;
+		q->defaultValue = defaultValue;
+		q->name = name;
+		q->unit = unit;
+		paramQuantities[paramId] = q;
+		params[paramId].value = defaultValue;
+		return q;
+	}
+
+	PortInfo *configInput(int portId, std::string name = "") { return configPort(inputInfos, portId, name); }
+	PortInfo *configOutput(int portId, std::string name = "") { return configPort(outputInfos, portId, name); }
+
+	PortInfo *configPort(std::vector<PortInfo*> &infos, int portId, std::string name) {
+		infos.resize(std::max((int) infos.size(), portId + 1), nullptr);
+		delete infos[portId];
+		infos[portId] = new PortInfo;
+		infos[portId]->name = name;
+		return infos[portId];
+	}
+
+	virtual void process(const ProcessArgs &args) {}
+	virtual void processBypass(const ProcessArgs &args) {}
+	virtual json_t *dataToJson() { return nullptr; }
+	virtual void dataFromJson(json_t *rootJ) {}
+	virtual void onReset() {}
+	virtual void onReset(const ResetEvent &e) { onReset(); }
+	virtual void onSampleRateChange() {}
+	virtual void onSampleRateChange(const SampleRateChangeEvent &e) { onSampleRateChange(); }
+};
+
+struct Engine {
+	float sampleRate = 48000.f;
+	float getSampleRate() { return sampleRate; }
+};
+
+} // namespace engine
+using namespace engine;
+
+////////// plugin //////////
+
+struct Model {
+	std::string slug;
+	std::function<Module*()> createModule;
+};
+
+struct Plugin {
+	std::vector<Model*> models;
+	void addModel(Model *model) { models.push_back(model); }
+};
+
+namespace asset {
+std::string plugin(Plugin *plugin, const std::string &filename);
+std::string user(const std::string &filename);
+}
+
+namespace system {
+std::string join(const std::string &path1, const std::string &path2);
+void createDirectories(const std::string &path);
+bool exists(const std::string &path);
+}
+
+////////// ui, inert //////////
+
+struct Font {
+	int handle = -1;
+};
+
+struct Svg {};
+
+namespace window {
+struct Window {
+	std::shared_ptr<Svg> loadSvg(const std::string &filename);
+	std::shared_ptr<Font> loadFont(const std::string &filename);
+	int getMods() { return 0; }
+};
+}
+
+namespace widget {
+
+struct Widget {
+	math::Rect box;
+	Widget *parent = nullptr;
+	std::vector<Widget*> children;
+
+	struct DrawArgs {
+		NVGcontext *vg;
+		math::Rect clipBox;
+	};
+	struct DragStartEvent {
+		int button;
+	};
+	struct DragMoveEvent {
+		math::Vec mouseDelta;
+	};
+	struct HoverScrollEvent {
+		math::Vec scrollDelta;
+		void consume(Widget *w) const {}
+	};
+
+	virtual ~Widget() {}
+	virtual void step() {}
+	virtual void draw(const DrawArgs &args) {}
+	virtual void drawLayer(const DrawArgs &args, int layer) {}
+	virtual void onDragStart(const DragStartEvent &e) {}
+	virtual void onDragMove(const DragMoveEvent &e) {}
+	virtual void onHoverScroll(const HoverScrollEvent &e) {}
+	void addChild(Widget *child) {
+		child->parent = this;
+		children.push_back(child);
+	}
+	template <class T>
+	T *getAncestorOfType() {
+		for (Widget *w = parent; w; w = w->parent) {
+			if (T *t = dynamic_cast<T*>(w))
+				return t;
+		}
+		return nullptr;
+	}
+};
+
+struct OpaqueWidget : Widget {};
+struct TransparentWidget : Widget {};
+struct FramebufferWidget : Widget {
+	bool dirty = true;
+	void setDirty(bool dirty = true) { this->dirty = dirty; }
+};
+
+} // namespace widget
+using namespace widget;
+
+namespace event {
+typedef Widget::DragStartEvent DragStart;
+typedef Widget::DragMoveEvent DragMove;
+typedef Widget::HoverScrollEvent HoverScroll;
+}
+
+namespace ui {
+struct Menu : Widget {};
+struct MenuItem : Widget {};
+struct MenuSeparator : MenuItem {};
+}
+using namespace ui;
+
+namespace app {
+
+struct PanelBorder : Widget {};
+struct ParamWidget : Widget {};
+struct PortWidget : Widget {};
+
+struct SvgKnob : ParamWidget {
+	float minAngle = 0.f, maxAngle = 0.f;
+	bool snap = false, smooth = true;
+	void setSvg(std::shared_ptr<Svg> svg) {}
+};
+
+struct SvgSwitch : ParamWidget {
+	struct Shadow {
+		float opacity = 1.f;
+	};
+	bool momentary = false;
+	Shadow shadowStorage;
+	Shadow *shadow = &shadowStorage;
+	void addFrame(std::shared_ptr<Svg> svg) {}
+};
+
+struct SvgPort : PortWidget {
+	void setSvg(std::shared_ptr<Svg> svg) {}
+};
+
+struct SvgScrew : Widget {
+	void setSvg(std::shared_ptr<Svg> svg) {}
+};
+
+struct RackWidget : Widget {
+	math::Vec getMousePos();
+	bool requestModulePos(Widget *w, math::Vec pos);
+};
+
+struct Scene : Widget {
+	RackWidget *rack = nullptr;
+};
+
+struct ModuleWidget : OpaqueWidget {
+	Module *module = nullptr;
+	void setModule(Module *module) { this->module = module; }
+	void setPanel(Widget *panel) { addChild(panel); }
+	void addParam(ParamWidget *param) { addChild(param); }
+	void addInput(PortWidget *input) { addChild(input); }
+	void addOutput(PortWidget *output) { addChild(output); }
+	virtual void appendContextMenu(Menu *menu) {}
+};
+
+} // namespace app
+using namespace app;
+
+struct Context {
+	engine::Engine *engine = nullptr;
+	window::Window *window = nullptr;
+	app::Scene *scene = nullptr;
+};
+
+Context *contextGet();
+#define APP rack::contextGet()
+
+////////// helpers //////////
+
+template <class TModule, class TModuleWidget>
+Model *createModel(const std::string &slug) {
+	Model *model = new Model;
+	model->slug = slug;
+	model->createModule = [model]() -> Module* {
+		Module *module = new TModule;
+		module->model = model;
+		return module;
+	};
+	return model;
+}
+
+template <class TWidget>
+TWidget *createWidget(math::Vec pos) {
+	TWidget *w = new TWidget;
+	w->box.pos = pos;
+	return w;
+}
+
+template <class TParamWidget>
+TParamWidget *createParam(math::Vec pos, Module *module, int paramId) { return createWidget<TParamWidget>(pos); }
+template <class TPortWidget>
+TPortWidget *createInput(math::Vec pos, Module *module, int inputId) { return createWidget<TPortWidget>(pos); }
+template <class TPortWidget>
+TPortWidget *createOutput(math::Vec pos, Module *module, int outputId) { return createWidget<TPortWidget>(pos); }
+
+Widget *createPanel(const std::string &svgPath);
+MenuItem *createMenuLabel(const std::string &text);
+MenuItem *createMenuItem(const std::string &text, const std::string &rightText, std::function<void()> action, bool disabled = false);
+MenuItem *createBoolMenuItem(const std::string &text, const std::string &rightText, std::function<bool()> getter, std::function<void(bool)> setter, bool disabled = false);
+MenuItem *createIndexSubmenuItem(const std::string &text, std::vector<std::string> labels, std::function<size_t()> getter, std::function<void(size_t)> setter, bool disabled = false);
+
+template <typename T>
+MenuItem *createBoolPtrMenuItem(const std::string &text, const std::string &rightText, T *ptr) { return new MenuItem; }
+template <typename T>
+MenuItem *createIndexPtrSubmenuItem(const std::string &text, std::vector<std::string> labels, T *ptr) { return new MenuItem; }
+
+} // namespace rack
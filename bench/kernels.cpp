@@ -0,0 +1,161 @@
+// attractor kernels from anomalous-math.hpp on their own, no Rack involved.
+// every attractor × integrator × lane type × voice count × step rate, timed
+// with and without the divergence check the modules run after each step.
+// prints csv, or json with --json
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "simd.hpp"
+#include "bench.hpp"
+
+using rack::simd::float_4;
+
+static const float SAMPLE_RATE = 48000.f;
+static const float CONTROL_RATE = 1500.f; // same as the modules' control rate
+static const int SAMPLES = 20000; // steps per measurement
+static const int WARMUP = 2000;
+static const int PAIRS = 15; // runs with and without the check, alternating
+static const int VOICES[] = {1, 4, 16};
+
+struct Result {
+	std::string attractor, integrator, lanes, rate;
+	int voices;
+	double ns, check;
+};
+
+// fixed step integrators are stateless policies, the adaptive one keeps its
+// current step per attractor, as in the modules
+template <class TIntegrator, class TAttractor, class TAdaptive>
+inline void step(TAttractor &a, TAdaptive &, float dt, TIntegrator) {
+	stepAttractor<TIntegrator>(a, dt);
+}
+
+template <class TAttractor, class TAdaptive>
+inline void step(TAttractor &a, TAdaptive &adaptive, float dt, AdaptiveIntegrator) {
+	adaptive.advance(a, dt);
+}
+
+// all voices of one measurement, with one attractor per float or float_4
+template <template <typename> class TAttractor, typename T, class TIntegrator>
+struct Voices {
+	std::vector<TAttractor<T>> attractors;
+	std::vector<TAdaptiveIntegrator<T>> adaptive;
+	std::vector<TDivergenceGuard<TAttractor<T>>> guards;
+	float dt;
+	bool check;
+
+	Voices(int voices, float dt, bool check) : dt(dt), check(check) {
+		const int lanes = sizeof(T) / sizeof(float);
+		const int count = (voices + lanes - 1) / lanes;
+		attractors.resize(count);
+		adaptive.resize(count);
+		guards.resize(count);
+		for (int i = 0; i < count; i++) {
+			attractors[i].speed = 1.f;
+			adaptive[i].tolerance = TAttractor<float>::TOLERANCE;
+			guards[i].reset(attractors[i]);
+		}
+	}
+
+	void run(int samples) {
+		for (int s = 0; s < samples; s++) {
+			for (size_t i = 0; i < attractors.size(); i++) {
+				step(attractors[i], adaptive[i], dt, TIntegrator());
+				if (check && guards[i].step(attractors[i]))
+					adaptive[i].reset();
+			}
+		}
+		benchSink = LaneOps<T>::max(attractors[0].x);
+	}
+};
+
+// ns per sample for all voices, the best run without the check, and what
+// the check adds. runs with and without it alternate, so the clock and the
+// cache drift under both alike, and the cost is the median of the paired
+// differences. a cost below the noise floor comes out as 0, not negative
+template <template <typename> class TAttractor, typename T, class TIntegrator>
+void measure(int voices, float dt, double &ns, double &check) {
+	Voices<TAttractor, T, TIntegrator> plain(voices, dt, false);
+	Voices<TAttractor, T, TIntegrator> checked(voices, dt, true);
+	plain.run(WARMUP);
+	checked.run(WARMUP);
+	ns = 1e30;
+	std::vector<double> differences;
+	for (int p = 0; p < PAIRS; p++) {
+		double a = benchTime([&]() { plain.run(SAMPLES); }, SAMPLES);
+		double b = benchTime([&]() { checked.run(SAMPLES); }, SAMPLES);
+		ns = std::min(ns, a);
+		differences.push_back(b - a);
+	}
+	std::sort(differences.begin(), differences.end());
+	check = std::max(differences[PAIRS / 2], 0.0);
+}
+
+template <template <typename> class TAttractor, typename T, class TIntegrator>
+void measureAll(const char *integrator, const char *lanes, std::vector<Result> &results) {
+	const char *rateNames[] = {"audio", "control"};
+	const float dts[] = {1.f / SAMPLE_RATE, 1.f / CONTROL_RATE};
+	for (int r = 0; r < 2; r++) {
+		for (int voices : VOICES) {
+			Result result;
+			result.attractor = TAttractor<float>::name();
+			result.integrator = integrator;
+			result.lanes = lanes;
+			result.rate = rateNames[r];
+			result.voices = voices;
+			measure<TAttractor, T, TIntegrator>(voices, dts[r], result.ns, result.check);
+			results.push_back(result);
+		}
+	}
+}
+
+template <template <typename> class TAttractor, typename T>
+void measureIntegrators(const char *lanes, std::vector<Result> &results) {
+	measureAll<TAttractor, T, EulerIntegrator>("euler", lanes, results);
+	measureAll<TAttractor, T, SemiImplicitEulerIntegrator>("semi-implicit euler", lanes, results);
+	measureAll<TAttractor, T, HeunIntegrator>("heun", lanes, results);
+	measureAll<TAttractor, T, Rk4Integrator>("rk4", lanes, results);
+	measureAll<TAttractor, T, AdaptiveIntegrator>("adaptive", lanes, results);
+}
+
+template <template <typename> class TAttractor>
+void measureAttractor(std::vector<Result> &results) {
+	measureIntegrators<TAttractor, float>("scalar", results);
+	measureIntegrators<TAttractor, float_4>("simd", results);
+}
+
+int main(int argc, char **argv) {
+	bool json = (argc > 1 && strcmp(argv[1], "--json") == 0);
+
+	std::vector<Result> results;
+	measureAttractor<THalvorsenAttractor>(results);
+	measureAttractor<TLorenzAttractor>(results);
+	measureAttractor<TThomasAttractor>(results);
+	measureAttractor<TSakaryaAttractor>(results);
+	measureAttractor<TDadrasAttractor>(results);
+	measureAttractor<TSprottLinzFAttractor>(results);
+
+	if (json)
+		printf("[\n");
+	else
+		printf("attractor,integrator,lanes,rate,voices,ns_per_sample,ns_per_voice,check_ns_per_sample\n");
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result &r = results[i];
+		if (json) {
+			printf("\t{\"attractor\": \"%s\", \"integrator\": \"%s\", \"lanes\": \"%s\", \"rate\": \"%s\", \"voices\": %d, "
+				"\"ns_per_sample\": %.3f, \"ns_per_voice\": %.3f, \"check_ns_per_sample\": %.3f}%s\n",
+				r.attractor.c_str(), r.integrator.c_str(), r.lanes.c_str(), r.rate.c_str(), r.voices,
+				r.ns, r.ns / r.voices, r.check, (i + 1 < results.size()) ? "," : "");
+		}
+		else {
+			printf("%s,%s,%s,%s,%d,%.3f,%.3f,%.3f\n",
+				r.attractor.c_str(), r.integrator.c_str(), r.lanes.c_str(), r.rate.c_str(), r.voices,
+				r.ns, r.ns / r.voices, r.check);
+		}
+	}
+	if (json)
+		printf("]\n");
+	return 0;
+}
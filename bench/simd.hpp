@@ -0,0 +1,76 @@
+// stand-in for the parts of rack::simd::float_4 the attractor kernels use,
+// so the benchmarks build without the Rack SDK
+
+#pragma once
+#include <math.h>
+#include <smmintrin.h>
+#include "anomalous-math.hpp"
+
+namespace rack {
+namespace simd {
+
+template <typename T, int N>
+struct Vector;
+
+template <>
+struct Vector<float, 4> {
+	union {
+		__m128 v;
+		float s[4];
+	};
+
+	Vector() = default;
+	Vector(__m128 v) : v(v) {}
+	Vector(float x) : v(_mm_set1_ps(x)) {}
+	Vector(float x1, float x2, float x3, float x4) : v(_mm_setr_ps(x1, x2, x3, x4)) {}
+	float &operator[](int i) { return s[i]; }
+	const float &operator[](int i) const { return s[i]; }
+	static Vector load(const float *x) { return Vector(_mm_loadu_ps(x)); }
+	void store(float *x) { _mm_storeu_ps(x, v); }
+};
+
+typedef Vector<float, 4> float_4;
+
+inline float_4 operator+(const float_4 &a, const float_4 &b) { return _mm_add_ps(a.v, b.v); }
+inline float_4 operator-(const float_4 &a, const float_4 &b) { return _mm_sub_ps(a.v, b.v); }
+inline float_4 operator*(const float_4 &a, const float_4 &b) { return _mm_mul_ps(a.v, b.v); }
+inline float_4 operator/(const float_4 &a, const float_4 &b) { return _mm_div_ps(a.v, b.v); }
+inline float_4 operator-(const float_4 &a) { return _mm_sub_ps(_mm_setzero_ps(), a.v); }
+inline float_4 operator&(const float_4 &a, const float_4 &b) { return _mm_and_ps(a.v, b.v); }
+inline float_4 operator|(const float_4 &a, const float_4 &b) { return _mm_or_ps(a.v, b.v); }
+inline float_4 operator<(const float_4 &a, const float_4 &b) { return _mm_cmplt_ps(a.v, b.v); }
+inline float_4 operator>(const float_4 &a, const float_4 &b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline float_4 &operator+=(float_4 &a, const float_4 &b) { return a = a + b; }
+inline float_4 &operator-=(float_4 &a, const float_4 &b) { return a = a - b; }
+inline float_4 &operator*=(float_4 &a, const float_4 &b) { return a = a * b; }
+
+inline int movemask(const float_4 &a) { return _mm_movemask_ps(a.v); }
+inline float_4 ifelse(const float_4 &mask, const float_4 &a, const float_4 &b) { return _mm_blendv_ps(b.v, a.v, mask.v); }
+inline float_4 fmin(const float_4 &a, const float_4 &b) { return _mm_min_ps(a.v, b.v); }
+inline float_4 fmax(const float_4 &a, const float_4 &b) { return _mm_max_ps(a.v, b.v); }
+inline float_4 fabs(const float_4 &a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a.v); }
+inline float_4 sqrt(const float_4 &a) { return _mm_sqrt_ps(a.v); }
+inline float_4 floor(const float_4 &a) { return _mm_floor_ps(a.v); }
+
+// lane by lane libm, for comparison
+inline float_4 sin(const float_4 &a) { return float_4(sinf(a[0]), sinf(a[1]), sinf(a[2]), sinf(a[3])); }
+
+} // namespace simd
+} // namespace rack
+
+// same as the one in attractor-lfo.hpp
+template <>
+struct LaneOps<rack::simd::float_4> {
+	typedef rack::simd::float_4 Mask;
+
+	static float max(rack::simd::float_4 v) {
+		float m = v[0];
+		for (int i = 1; i < 4; i++)
+			m = (v[i] > m || v[i] != v[i]) ? v[i] : m;
+		return m;
+	}
+
+	static Mask within(rack::simd::float_4 v, float bound) { return rack::simd::fabs(v) < bound; }
+	static rack::simd::float_4 select(Mask m, rack::simd::float_4 a, rack::simd::float_4 b) { return rack::simd::ifelse(m, a, b); }
+	static bool all(Mask m) { return rack::simd::movemask(m) == 0xf; }
+};
@@ -0,0 +1,83 @@
+// fastSin against libm, for the thomas attractor
+// prints csv: function, ns per value, max abs error on [-pi, pi], [-100, 100] and [-1000, 1000]
+
+#include <math.h>
+#include <vector>
+#include "simd.hpp"
+#include "bench.hpp"
+
+using rack::simd::float_4;
+
+static const int SIZE = 4096;
+static const int REPEATS = 2000;
+
+template <class F>
+double maxError(F f, float range) {
+	double error = 0.0;
+	for (int i = 0; i <= 1000000; i++) {
+		float x = -range + 2.f * range * i / 1000000;
+		error = fmax(error, fabs(f(x) - sin((double) x)));
+	}
+	return error;
+}
+
+int main() {
+	// thomas states mostly stay within a few radians
+	std::vector<float> in(SIZE);
+	for (int i = 0; i < SIZE; i++)
+		in[i] = -6.f + 12.f * i / SIZE;
+	const long count = (long) SIZE * REPEATS;
+
+	printf("function,ns_per_value,max_error_pi,max_error_100,max_error_1000\n");
+
+	double ns = benchmark([&]() {
+		float sum = 0.f;
+		for (int r = 0; r < REPEATS; r++, benchBarrier())
+			for (int i = 0; i < SIZE; i++)
+				sum += (float) sin((double) in[i]);
+		benchSink = sum;
+	}, count);
+	auto libmDouble = [](float x) { return (float) sin((double) x); };
+	printf("sin (double),%.3f,%.3g,%.3g,%.3g\n", ns, maxError(libmDouble, M_PI), maxError(libmDouble, 100.f), maxError(libmDouble, 1000.f));
+
+	ns = benchmark([&]() {
+		float sum = 0.f;
+		for (int r = 0; r < REPEATS; r++, benchBarrier())
+			for (int i = 0; i < SIZE; i++)
+				sum += sinf(in[i]);
+		benchSink = sum;
+	}, count);
+	auto libmFloat = [](float x) { return sinf(x); };
+	printf("sinf,%.3f,%.3g,%.3g,%.3g\n", ns, maxError(libmFloat, M_PI), maxError(libmFloat, 100.f), maxError(libmFloat, 1000.f));
+
+	ns = benchmark([&]() {
+		float sum = 0.f;
+		for (int r = 0; r < REPEATS; r++, benchBarrier())
+			for (int i = 0; i < SIZE; i++)
+				sum += fastSin(in[i]);
+		benchSink = sum;
+	}, count);
+	auto fast = [](float x) { return fastSin(x); };
+	printf("fastSin<float>,%.3f,%.3g,%.3g,%.3g\n", ns, maxError(fast, M_PI), maxError(fast, 100.f), maxError(fast, 1000.f));
+
+	ns = benchmark([&]() {
+		float_4 sum = 0.f;
+		for (int r = 0; r < REPEATS; r++, benchBarrier())
+			for (int i = 0; i < SIZE; i += 4)
+				sum += rack::simd::sin(float_4::load(&in[i]));
+		benchSink = sum[0] + sum[1] + sum[2] + sum[3];
+	}, count);
+	printf("sinf x4,%.3f,,,\n", ns);
+
+	ns = benchmark([&]() {
+		float_4 sum = 0.f;
+		for (int r = 0; r < REPEATS; r++, benchBarrier())
+			for (int i = 0; i < SIZE; i += 4)
+				sum += fastSin(float_4::load(&in[i]));
+		benchSink = sum[0] + sum[1] + sum[2] + sum[3];
+	}, count);
+	auto fast4 = [](float x) { return fastSin(float_4(x))[0]; };
+	printf("fastSin<float_4>,%.3f,%.3g,%.3g,%.3g\n", ns, maxError(fast4, M_PI), maxError(fast4, 100.f), maxError(fast4, 1000.f));
+
+	return 0;
+}
@@ -1,148 +1,630 @@
-// wiqid math stuff
-
-#pragma once
-#include <math.h>
-
-// attractor code based on https://github.com/joelrobichaud/Nohmad/blob/master/src/StrangeAttractors.cpp
-// by Joel Robichaud, MIT licensed
-// and formulas from Jürgen Meier's website http://www.3d-meier.de/tut19/Seite0.html
-
-struct HalvorsenAttractor {
-	float a, speed; // params
-	float x, y, z; // outs
-
-	static constexpr float DEFAULT_A = 1.43f;
-	static constexpr float DEFAULT_SPEED = 0.5f;
-
-	HalvorsenAttractor() :
-		a(DEFAULT_A), speed(DEFAULT_SPEED),
-		x(1.0f), y(0.0f), z(0.0f) {}
-
-	void process(float dt) {
-		float dx = (-a * x) - (4 * y) - (4 * z) - (y * y);
-		float dy = (-a * y) - (4 * z) - (4 * x) - (z * z);
-		float dz = (-a * z) - (4 * x) - (4 * y) - (x * x);
-
-		x += dx * dt * speed * speed;
-        y += dy * dt * speed * speed;
-        z += dz * dt * speed * speed;
-	}
-};
-
-struct LorenzAttractor {
-    float sigma, beta, rho, speed; // params
-    float x, y, z; // outs
-
-    static constexpr float DEFAULT_S = 10.0f;
-    static constexpr float DEFAULT_B = 8.0f / 3.0f;
-    static constexpr float DEFAULT_R = 28.0f;
-    static constexpr float DEFAULT_SPEED = 0.5f;
-
-    LorenzAttractor() :
-        sigma(DEFAULT_S), beta(DEFAULT_B), rho(DEFAULT_R), speed(DEFAULT_SPEED),
-        x(1.0f), y(1.0f), z(1.0f) {}
-
-    void process(float dt) {
-        float dx = sigma * (y - x);
-        float dy = x * (rho - z) - y;
-        float dz = (x * y) - (beta * z);
-
-        x += dx * dt * speed * speed;
-        y += dy * dt * speed * speed;
-        z += dz * dt * speed * speed;
-    }
-};
-
-struct ThomasAttractor {
-	float b, speed; // params
-	float x, y, z; // outs
-
-	static constexpr float DEFAULT_B = 0.188f;
-	static constexpr float DEFAULT_SPEED = 0.5f;
-
-	ThomasAttractor() :
-		b(DEFAULT_B), speed(DEFAULT_SPEED),
-		x(0.1f), y(0.0f), z(0.0f) {}
-
-	void process(float dt) {
-		float dx = -b * x + sin(y);
-		float dy = -b * y + sin(z);
-		float dz = -b * z + sin(x);
-
-		x += dx * dt * speed * speed;
-        y += dy * dt * speed * speed;
-        z += dz * dt * speed * speed;
-	}
-};
-
-struct SakaryaAttractor {
-	float a, b, speed; // params
-	float x, y, z; // outs
-
-	static constexpr float DEFAULT_A = 0.398f;
-	static constexpr float DEFAULT_B = 0.3f;
-	static constexpr float DEFAULT_SPEED = 0.5f;
-
-	SakaryaAttractor() :
-		a(DEFAULT_A), b(DEFAULT_B), speed(DEFAULT_SPEED),
-		x(1.0f), y(-1.0f), z(1.0f) {}
-
-	void process(float dt) {
-		float dx = -x + y + y * z;
-		float dy = -x - y + a * x * z;
-		float dz = z - b * x * y;
-
-		x += dx * dt * speed * speed;
-        y += dy * dt * speed * speed;
-        z += dz * dt * speed * speed;
-	}
-};
-
-struct DadrasAttractor {
-	float p, q, r, s, e, speed; // params
-	float x, y, z; // outs
-
-	static constexpr float DEFAULT_P = 3.0f;
-	static constexpr float DEFAULT_Q = 2.75f;
-	static constexpr float DEFAULT_R = 1.7f;
-	static constexpr float DEFAULT_S = 2.0f;
-	static constexpr float DEFAULT_E = 9.0f;
-	static constexpr float DEFAULT_SPEED = 0.5f;
-
-	DadrasAttractor() :
-		p(DEFAULT_P), q(DEFAULT_Q), r(DEFAULT_R), s(DEFAULT_S),
-		e(DEFAULT_E), speed(DEFAULT_SPEED),
-		x(1.0f), y(1.0f), z(0.0f) {}
-
-	void process(float dt) {
-		float dx = y - p * x + q * y * z;
-		float dy = r * y - x * z + z;
-		float dz = s * x * y - e * z;
-
-		x += dx * dt * speed * speed;
-        y += dy * dt * speed * speed;
-        z += dz * dt * speed * speed;
-	}
-};
-
-struct SprottLinzFAttractor {
-	float a, speed; // params
-	float x, y, z; // outs
-
-	static constexpr float DEFAULT_A = 0.5f;
-	static constexpr float DEFAULT_SPEED = 0.5f;
-
-	SprottLinzFAttractor() :
-		a(DEFAULT_A), speed(DEFAULT_SPEED),
-		x(0.1f), y(0.0f), z(0.0f) {}
-
-	void process(float dt) {
-		float dx = y + z;
-		float dy = -x + a * y;
-		float dz = x * x - z;
-
-		x += dx * dt * speed * speed;
-        y += dy * dt * speed * speed;
-        z += dz * dt * speed * speed;
-	}
-};
+// wiqid math stuff
+
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+// attractor code based on https://github.com/joelrobichaud/Nohmad/blob/master/src/StrangeAttractors.cpp
+// by Joel Robichaud, MIT licensed
+// and formulas from Jürgen Meier's website http://www.3d-meier.de/tut19/Seite0.html
+
+// the attractors are templated on their value type, so the same equations run
+// on a single float or on four voices at once in a simd::float_4
+
+// per-lane tests and reductions for a value type, specialised for vector
+// types next to where they are defined
+template <typename T>
+struct LaneOps;
+
+template <>
+struct LaneOps<float> {
+	typedef bool Mask;
+	static float max(float x) { return x; }
+	static Mask within(float x, float bound) { return fabsf(x) < bound; }
+	static float select(Mask m, float a, float b) { return m ? a : b; }
+	static bool all(Mask m) { return m; }
+};
+
+////////// fast math //////////
+
+// sine for float or any vector type with floor(): reduced to [-pi, pi], then
+// x (pi^2 - x^2) P(x^2) with minimax coefficients for P, which is exact at 0
+// and ±pi. max abs error is 6.7e-6 on [-pi, pi] and 1.2e-5 out to |x| = 100,
+// growing to 6.2e-5 at |x| = 1000 as the reduction loses bits. bench/sine.cpp
+// measures it against libm
+template <typename T>
+inline T fastSin(T x) {
+	T k = floor(x * 0.159154943f + 0.5f);
+	x = (x - k * 6.28125f) - k * 1.93530717e-3f;
+	T x2 = x * x;
+	T p = ((-2.136588591e-6f * x2 + 1.713380771e-4f) * x2 - 6.616479717e-3f) * x2 + 1.013188809e-1f;
+	return x * (9.8696044f - x2) * p;
+}
+
+////////// integrators //////////
+
+// each attractor only describes its equations in derive(), the integrator is a
+// policy on top, so every attractor/integrator pair compiles to its own kernel
+
+enum IntegratorIds {
+	EULER_INTEGRATOR,
+	SEMI_IMPLICIT_EULER_INTEGRATOR,
+	HEUN_INTEGRATOR,
+	RK4_INTEGRATOR,
+	ADAPTIVE_INTEGRATOR,
+	NUM_INTEGRATORS
+};
+
+// forward euler, one derivative per step
+struct EulerIntegrator {
+	template <class TSystem, typename T>
+	static void step(const TSystem &sys, T &x, T &y, T &z, T h) {
+		T dx, dy, dz;
+		sys.derive(x, y, z, dx, dy, dz);
+		x += dx * h;
+		y += dy * h;
+		z += dz * h;
+	}
+};
+
+// each coordinate sees the ones already updated in this step, which keeps
+// oscillating systems from spiralling outwards like forward euler does.
+// once inlined, the unused parts of the extra derivatives are dropped
+struct SemiImplicitEulerIntegrator {
+	template <class TSystem, typename T>
+	static void step(const TSystem &sys, T &x, T &y, T &z, T h) {
+		T dx, dy, dz;
+		sys.derive(x, y, z, dx, dy, dz);
+		x += dx * h;
+		sys.derive(x, y, z, dx, dy, dz);
+		y += dy * h;
+		sys.derive(x, y, z, dx, dy, dz);
+		z += dz * h;
+	}
+};
+
+// heun's method (explicit trapezoid), second order
+struct HeunIntegrator {
+	template <class TSystem, typename T>
+	static void step(const TSystem &sys, T &x, T &y, T &z, T h) {
+		T dx1, dy1, dz1, dx2, dy2, dz2;
+		sys.derive(x, y, z, dx1, dy1, dz1);
+		sys.derive(x + dx1 * h, y + dy1 * h, z + dz1 * h, dx2, dy2, dz2);
+		x += (dx1 + dx2) * (h * 0.5f);
+		y += (dy1 + dy2) * (h * 0.5f);
+		z += (dz1 + dz2) * (h * 0.5f);
+	}
+};
+
+// classic fourth order runge-kutta
+struct Rk4Integrator {
+	template <class TSystem, typename T>
+	static void step(const TSystem &sys, T &x, T &y, T &z, T h) {
+		T dx1, dy1, dz1, dx2, dy2, dz2, dx3, dy3, dz3, dx4, dy4, dz4;
+		T h2 = h * 0.5f;
+		sys.derive(x, y, z, dx1, dy1, dz1);
+		sys.derive(x + dx1 * h2, y + dy1 * h2, z + dz1 * h2, dx2, dy2, dz2);
+		sys.derive(x + dx2 * h2, y + dy2 * h2, z + dz2 * h2, dx3, dy3, dz3);
+		sys.derive(x + dx3 * h, y + dy3 * h, z + dz3 * h, dx4, dy4, dz4);
+		T h6 = h * (1.f / 6.f);
+		x += (dx1 + 2.f * (dx2 + dx3) + dx4) * h6;
+		y += (dy1 + 2.f * (dy2 + dy3) + dy4) * h6;
+		z += (dz1 + 2.f * (dz2 + dz3) + dz4) * h6;
+	}
+};
+
+// the attractor kernel: advance by dt seconds, time runs at speed squared
+template <class TIntegrator, class TAttractor>
+inline void stepAttractor(TAttractor &a, float dt) {
+	TIntegrator::step(a, a.x, a.y, a.z, dt * a.speed * a.speed);
+}
+
+// since chaotic values can escape to infinity, the state is checked every
+// INTERVAL steps, per lane and without branches: a lane is good while all of
+// x, y and z lie within the attractor's BOUND, which also fails for nan and
+// infinity and catches most lanes on their way out, before they overflow.
+// good lanes are snapshotted into a small ring, and a lane that failed is
+// rolled back to the oldest snapshot with a small nudge, so it doesn't
+// retrace the path that took it out. a lane that keeps failing was already
+// escaping when the snapshots were taken, and only then starts over from the
+// attractor's starting point. never from the origin, which is a fixed point
+// of every attractor here
+template <class TAttractor>
+struct TDivergenceGuard {
+	typedef decltype(TAttractor().x) T;
+	typedef LaneOps<T> Ops;
+
+	static constexpr int SNAPSHOTS = 4;
+	static constexpr int INTERVAL = 16; // steps between checks
+	static constexpr float MAX_STRIKES = 3.f; // recent rollbacks before starting over
+	static constexpr float STRIKE_DECAY = 0.95f; // per good check, so strikes add up while a lane keeps failing
+	static constexpr float NUDGE = 1e-4f; // of the bound
+
+	T snapshots[SNAPSHOTS][3];
+	T strikes = 0.f; // recent rollbacks, per lane
+	int head = 0; // oldest snapshot, overwritten next
+	int countdown = INTERVAL;
+	uint32_t seed = 0x9e3779b9u; // for the nudges
+
+	// restart the ring from the current state, lanes that are already out of
+	// bounds start over from the starting point
+	void reset(TAttractor &a) {
+		typename Ops::Mask good = inside(a);
+		a.x = Ops::select(good, a.x, start().x);
+		a.y = Ops::select(good, a.y, start().y);
+		a.z = Ops::select(good, a.z, start().z);
+		for (int i = 0; i < SNAPSHOTS; i++) {
+			snapshots[i][0] = a.x;
+			snapshots[i][1] = a.y;
+			snapshots[i][2] = a.z;
+		}
+		strikes = 0.f;
+		countdown = INTERVAL;
+	}
+
+	// call after every step, returns whether any lane was rolled back
+	bool step(TAttractor &a) {
+		if (--countdown > 0)
+			return false;
+		countdown = INTERVAL;
+		return check(a);
+	}
+
+	bool check(TAttractor &a) {
+		typename Ops::Mask good = inside(a);
+		strikes = Ops::select(good, strikes * STRIKE_DECAY, strikes + 1.f);
+		typename Ops::Mask restart = (strikes > MAX_STRIKES);
+		strikes = Ops::select(restart, T(0.f), strikes);
+
+		// xorshift, so repeated rollbacks of a lane take different paths
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		float nudge = ((int32_t) seed * (1.f / 2147483648.f)) * (NUDGE * TAttractor::BOUND);
+		const T *oldest = snapshots[head];
+		T x = Ops::select(restart, start().x, oldest[0] + nudge);
+		T y = Ops::select(restart, start().y, oldest[1] - nudge);
+		T z = Ops::select(restart, start().z, oldest[2] + nudge);
+		a.x = Ops::select(good, a.x, x);
+		a.y = Ops::select(good, a.y, y);
+		a.z = Ops::select(good, a.z, z);
+
+		// the newest snapshot is the state going on. failed lanes get it in
+		// every slot, so a lane failing again goes back to the same point
+		for (int i = 0; i < SNAPSHOTS; i++) {
+			snapshots[i][0] = Ops::select(good, snapshots[i][0], a.x);
+			snapshots[i][1] = Ops::select(good, snapshots[i][1], a.y);
+			snapshots[i][2] = Ops::select(good, snapshots[i][2], a.z);
+		}
+		snapshots[head][0] = a.x;
+		snapshots[head][1] = a.y;
+		snapshots[head][2] = a.z;
+		head = (head + 1) % SNAPSHOTS;
+
+		return !Ops::all(good);
+	}
+
+	static typename Ops::Mask inside(const TAttractor &a) {
+		return Ops::within(a.x, TAttractor::BOUND) & Ops::within(a.y, TAttractor::BOUND) & Ops::within(a.z, TAttractor::BOUND);
+	}
+
+	static const TAttractor &start() {
+		static const TAttractor a;
+		return a;
+	}
+};
+
+// cheapest integrator that stays accurate for a step of h attractor time,
+// given the attractor's stiffness
+inline IntegratorIds chooseIntegrator(float h, float stiffness) {
+	float k = h * stiffness;
+	if (k < 0.02f)
+		return EULER_INTEGRATOR;
+	if (k < 0.2f)
+		return HEUN_INTEGRATOR;
+	if (k < 1.f)
+		return RK4_INTEGRATOR;
+	return ADAPTIVE_INTEGRATOR;
+}
+
+// marker policy for ADAPTIVE_INTEGRATOR, which needs a TAdaptiveIntegrator
+// object per attractor instead of a static step()
+struct AdaptiveIntegrator {};
+
+// bogacki-shampine 3(2) with error control. steps are as long as the local
+// error allows, possibly much longer than one call, and calls in between are
+// served from the cubic hermite through both ends of the current step. calm
+// stretches then cost one interpolation per call, while fast or stiff ones get
+// as many substeps as they need. all lanes share one step size, so they must
+// share the same speed
+template <typename T = float>
+struct TAdaptiveIntegrator {
+	static constexpr float MAX_STEP = 0.25f; // attractor time
+	static constexpr int MAX_SUBSTEPS = 32; // per call, keeps the worst case bounded
+	static constexpr int MAX_TRIALS = 8; // per substep
+
+	float tolerance = 1e-3f; // allowed local error, relative to 1 + |state|
+	float h = 1e-3f; // next trial step
+	float length = 0.f; // current step
+	float pos = 0.f; // output position within the current step
+	unsigned long rejected = 0; // trial steps thrown away for too much error
+	bool valid = false;
+
+	T x0, y0, z0, dx0, dy0, dz0; // start of the current step
+	T x1, y1, z1, dx1, dy1, dz1; // end of the current step
+
+	// restart from whatever state the attractor has now
+	void reset() {
+		valid = false;
+	}
+
+	template <class TAttractor>
+	void advance(TAttractor &a, float dt) {
+		float span = LaneOps<T>::max(dt * a.speed * a.speed);
+		if (!valid) {
+			valid = true;
+			x1 = a.x;
+			y1 = a.y;
+			z1 = a.z;
+			a.derive(x1, y1, z1, dx1, dy1, dz1);
+			length = 0.f;
+			pos = 0.f;
+		}
+
+		pos += span;
+		float minStep = span * (1.f / MAX_SUBSTEPS);
+		while (pos > length) {
+			pos -= length;
+			x0 = x1;
+			y0 = y1;
+			z0 = z1;
+			dx0 = dx1;
+			dy0 = dy1;
+			dz0 = dz1;
+			substep(a, minStep);
+		}
+		// a zero span before the first step takes none, the state stays put
+		if (length <= 0.f)
+			return;
+
+		// hermite basis in the step's own time
+		float s = pos / length;
+		float s2 = s * s;
+		float s3 = s2 * s;
+		float h00 = 2.f * s3 - 3.f * s2 + 1.f;
+		float h10 = (s3 - 2.f * s2 + s) * length;
+		float h01 = 3.f * s2 - 2.f * s3;
+		float h11 = (s3 - s2) * length;
+		a.x = h00 * x0 + h10 * dx0 + h01 * x1 + h11 * dx1;
+		a.y = h00 * y0 + h10 * dy0 + h01 * y1 + h11 * dy1;
+		a.z = h00 * z0 + h10 * dz0 + h01 * z1 + h11 * dz1;
+	}
+
+	// one accepted step from the start point, sets the end point and length
+	template <class TSystem>
+	void substep(const TSystem &sys, float minStep) {
+		for (int trial = 0;; trial++) {
+			float step = fminf(fmaxf(h, minStep), MAX_STEP);
+			T dx2, dy2, dz2, dx3, dy3, dz3;
+			sys.derive(x0 + dx0 * (0.5f * step), y0 + dy0 * (0.5f * step), z0 + dz0 * (0.5f * step), dx2, dy2, dz2);
+			sys.derive(x0 + dx2 * (0.75f * step), y0 + dy2 * (0.75f * step), z0 + dz2 * (0.75f * step), dx3, dy3, dz3);
+			x1 = x0 + (dx0 * (2.f / 9.f) + dx2 * (1.f / 3.f) + dx3 * (4.f / 9.f)) * step;
+			y1 = y0 + (dy0 * (2.f / 9.f) + dy2 * (1.f / 3.f) + dy3 * (4.f / 9.f)) * step;
+			z1 = z0 + (dz0 * (2.f / 9.f) + dz2 * (1.f / 3.f) + dz3 * (4.f / 9.f)) * step;
+			// first same as last: this is also the next step's first derivative
+			sys.derive(x1, y1, z1, dx1, dy1, dz1);
+
+			// difference to the embedded second order solution
+			T ex = (dx0 * (-5.f / 72.f) + dx2 * (1.f / 12.f) + dx3 * (1.f / 9.f) + dx1 * (-1.f / 8.f)) * step;
+			T ey = (dy0 * (-5.f / 72.f) + dy2 * (1.f / 12.f) + dy3 * (1.f / 9.f) + dy1 * (-1.f / 8.f)) * step;
+			T ez = (dz0 * (-5.f / 72.f) + dz2 * (1.f / 12.f) + dz3 * (1.f / 9.f) + dz1 * (-1.f / 8.f)) * step;
+			T ratio = errorRatio(ex, x1);
+			ratio = fmax(ratio, errorRatio(ey, y1));
+			ratio = fmax(ratio, errorRatio(ez, z1));
+			float error = LaneOps<T>::max(ratio);
+
+			// nan fails both comparisons, so a blown up trial is rejected too
+			bool accepted = (error <= 1.f);
+			float factor = accepted ? 5.f : 1.f;
+			if (error > 0.f)
+				factor = fminf(factor, fmaxf(0.9f * powf(error, -1.f / 3.f), 0.2f));
+			else if (!accepted)
+				factor = 0.2f;
+
+			if (accepted || step <= minStep || trial + 1 >= MAX_TRIALS) {
+				length = step;
+				h = step * factor;
+				return;
+			}
+			rejected++;
+			h = step * factor;
+		}
+	}
+
+	T errorRatio(T e, T v) const {
+		return fabs(e) / (tolerance * (1.f + fabs(v)));
+	}
+};
+
+////////// interpolation //////////
+
+// smooth curve through points pushed at a fixed control rate, read back at any
+// phase t in [0, 1) between two pushes. cubic is catmull-rom and lags one
+// extra control step behind linear
+template <typename T = float>
+struct TControlCurve {
+	T p0, p1, p2, p3; // last four points, p3 newest
+	T c0, c1, c2, c3; // polynomial for the current segment
+
+	TControlCurve() {
+		reset(0.f);
+	}
+
+	void reset(T v) {
+		p0 = p1 = p2 = p3 = v;
+		c0 = v;
+		c1 = c2 = c3 = 0.f;
+	}
+
+	void push(T v, bool cubic) {
+		p0 = p1;
+		p1 = p2;
+		p2 = p3;
+		p3 = v;
+		if (cubic) {
+			// segment from p1 to p2
+			c0 = p1;
+			c1 = 0.5f * (p2 - p0);
+			c2 = p0 - 2.5f * p1 + 2.f * p2 - 0.5f * p3;
+			c3 = 0.5f * (p3 - p0) + 1.5f * (p1 - p2);
+		}
+		else {
+			// segment from p2 to p3
+			c0 = p2;
+			c1 = p3 - p2;
+			c2 = c3 = 0.f;
+		}
+	}
+
+	T eval(float t) const {
+		return ((c3 * t + c2) * t + c1) * t + c0;
+	}
+};
+
+////////// output ranging //////////
+
+// running range of a signal per lane, for mapping it onto ±1. fed with the
+// extremes of a whole block at a time: the range widens at once to take in
+// new extremes and relaxes towards the running mean at rate relax, so a
+// signal that shrinks fills the range again without ever clipping
+template <typename T = float>
+struct TRangeNormalizer {
+	static constexpr float MIN_SPAN = 0.01f; // of the seeded span, so a voice at rest isn't blown up into noise
+
+	T lo = -1.f, hi = 1.f, mean = 0.f;
+	T minSpan = 2.f * MIN_SPAN;
+	T gain = 1.f, offset = 0.f; // gain * value + offset lies within ±1
+
+	void reset(T lo, T hi) {
+		this->lo = fmin(lo, hi);
+		this->hi = fmax(lo, hi);
+		mean = 0.5f * (lo + hi);
+		minSpan = MIN_SPAN * (this->hi - this->lo);
+		update();
+	}
+
+	void push(T blockLo, T blockHi, float relax, float smooth) {
+		mean += (0.5f * (blockLo + blockHi) - mean) * smooth;
+		lo = fmin(blockLo, lo + (mean - lo) * relax);
+		hi = fmax(blockHi, hi + (mean - hi) * relax);
+		update();
+	}
+
+	void update() {
+		T span = fmax(hi - lo, minSpan);
+		gain = 2.f / span;
+		offset = -(hi + lo) / span;
+	}
+};
+
+////////// attractors //////////
+
+template <typename T = float>
+struct THalvorsenAttractor {
+	T a, speed; // params
+	T x, y, z; // outs
+
+	static constexpr float DEFAULT_A = 1.43f;
+	static constexpr float DEFAULT_SPEED = 0.5f;
+	static constexpr float STIFFNESS = 20.0f; // rough size of the jacobian on the attractor
+	static constexpr float BOUND = 60.0f; // well outside every orbit over the shape range
+	static constexpr float TOLERANCE = 1e-3f; // adaptive integrator error per step
+
+	THalvorsenAttractor() :
+		a(DEFAULT_A), speed(DEFAULT_SPEED),
+		x(1.0f), y(0.0f), z(0.0f) {}
+
+	T &shape() { return a; } // variable behind the shape knob
+	static const char *name() { return "halvorsen"; } // key in res/trajectories.bin
+
+	// right-hand side of the equations at (x, y, z)
+	void derive(T x, T y, T z, T &dx, T &dy, T &dz) const {
+		dx = (-a * x) - (4 * y) - (4 * z) - (y * y);
+		dy = (-a * y) - (4 * z) - (4 * x) - (z * z);
+		dz = (-a * z) - (4 * x) - (4 * y) - (x * x);
+	}
+
+	void process(float dt) {
+		stepAttractor<EulerIntegrator>(*this, dt);
+	}
+};
+
+typedef THalvorsenAttractor<> HalvorsenAttractor;
+
+template <typename T = float>
+struct TLorenzAttractor {
+    T sigma, beta, rho, speed; // params
+    T x, y, z; // outs
+
+    static constexpr float DEFAULT_S = 10.0f;
+    static constexpr float DEFAULT_B = 8.0f / 3.0f;
+    static constexpr float DEFAULT_R = 28.0f;
+    static constexpr float DEFAULT_SPEED = 0.5f;
+    static constexpr float STIFFNESS = 25.0f; // rough size of the jacobian on the attractor
+    static constexpr float BOUND = 200.0f; // well outside every orbit over the shape range
+    static constexpr float TOLERANCE = 1e-3f; // adaptive integrator error per step
+
+    TLorenzAttractor() :
+        sigma(DEFAULT_S), beta(DEFAULT_B), rho(DEFAULT_R), speed(DEFAULT_SPEED),
+        x(1.0f), y(1.0f), z(1.0f) {}
+
+    T &shape() { return beta; } // variable behind the shape knob
+    static const char *name() { return "lorenz"; } // key in res/trajectories.bin
+
+    // right-hand side of the equations at (x, y, z)
+    void derive(T x, T y, T z, T &dx, T &dy, T &dz) const {
+        dx = sigma * (y - x);
+        dy = x * (rho - z) - y;
+        dz = (x * y) - (beta * z);
+    }
+
+    void process(float dt) {
+        stepAttractor<EulerIntegrator>(*this, dt);
+    }
+};
+
+typedef TLorenzAttractor<> LorenzAttractor;
+
+template <typename T = float>
+struct TThomasAttractor {
+	T b, speed; // params
+	T x, y, z; // outs
+
+	static constexpr float DEFAULT_B = 0.188f;
+	static constexpr float DEFAULT_SPEED = 0.5f;
+	static constexpr float STIFFNESS = 1.2f; // rough size of the jacobian on the attractor
+	static constexpr float BOUND = 50.0f; // well outside every orbit over the shape range
+	static constexpr float TOLERANCE = 1e-3f; // adaptive integrator error per step
+
+	TThomasAttractor() :
+		b(DEFAULT_B), speed(DEFAULT_SPEED),
+		x(0.1f), y(0.0f), z(0.0f) {}
+
+	T &shape() { return b; } // variable behind the shape knob
+	static const char *name() { return "thomas"; } // key in res/trajectories.bin
+
+	// right-hand side of the equations at (x, y, z)
+	void derive(T x, T y, T z, T &dx, T &dy, T &dz) const {
+		dx = -b * x + fastSin(y);
+		dy = -b * y + fastSin(z);
+		dz = -b * z + fastSin(x);
+	}
+
+	void process(float dt) {
+		stepAttractor<EulerIntegrator>(*this, dt);
+	}
+};
+
+typedef TThomasAttractor<> ThomasAttractor;
+
+template <typename T = float>
+struct TSakaryaAttractor {
+	T a, b, speed; // params
+	T x, y, z; // outs
+
+	static constexpr float DEFAULT_A = 0.398f;
+	static constexpr float DEFAULT_B = 0.3f;
+	static constexpr float DEFAULT_SPEED = 0.5f;
+	static constexpr float STIFFNESS = 10.0f; // rough size of the jacobian on the attractor
+	static constexpr float BOUND = 200.0f; // well outside every orbit over the shape range
+	static constexpr float TOLERANCE = 2e-4f; // adaptive integrator error per step
+
+	TSakaryaAttractor() :
+		a(DEFAULT_A), b(DEFAULT_B), speed(DEFAULT_SPEED),
+		x(1.0f), y(-1.0f), z(1.0f) {}
+
+	T &shape() { return b; } // variable behind the shape knob
+	static const char *name() { return "sakarya"; } // key in res/trajectories.bin
+
+	// right-hand side of the equations at (x, y, z)
+	void derive(T x, T y, T z, T &dx, T &dy, T &dz) const {
+		dx = -x + y + y * z;
+		dy = -x - y + a * x * z;
+		dz = z - b * x * y;
+	}
+
+	void process(float dt) {
+		stepAttractor<EulerIntegrator>(*this, dt);
+	}
+};
+
+typedef TSakaryaAttractor<> SakaryaAttractor;
+
+template <typename T = float>
+struct TDadrasAttractor {
+	T p, q, r, s, e, speed; // params
+	T x, y, z; // outs
+
+	static constexpr float DEFAULT_P = 3.0f;
+	static constexpr float DEFAULT_Q = 2.75f;
+	static constexpr float DEFAULT_R = 1.7f;
+	static constexpr float DEFAULT_S = 2.0f;
+	static constexpr float DEFAULT_E = 9.0f;
+	static constexpr float DEFAULT_SPEED = 0.5f;
+	static constexpr float STIFFNESS = 15.0f; // rough size of the jacobian on the attractor
+	static constexpr float BOUND = 100.0f; // well outside every orbit over the shape range
+	static constexpr float TOLERANCE = 5e-4f; // adaptive integrator error per step
+
+	TDadrasAttractor() :
+		p(DEFAULT_P), q(DEFAULT_Q), r(DEFAULT_R), s(DEFAULT_S),
+		e(DEFAULT_E), speed(DEFAULT_SPEED),
+		x(1.0f), y(1.0f), z(0.0f) {}
+
+	T &shape() { return q; } // variable behind the shape knob
+	static const char *name() { return "dadras"; } // key in res/trajectories.bin
+
+	// right-hand side of the equations at (x, y, z)
+	void derive(T x, T y, T z, T &dx, T &dy, T &dz) const {
+		dx = y - p * x + q * y * z;
+		dy = r * y - x * z + z;
+		dz = s * x * y - e * z;
+	}
+
+	void process(float dt) {
+		stepAttractor<EulerIntegrator>(*this, dt);
+	}
+};
+
+typedef TDadrasAttractor<> DadrasAttractor;
+
+template <typename T = float>
+struct TSprottLinzFAttractor {
+	T a, speed; // params
+	T x, y, z; // outs
+
+	static constexpr float DEFAULT_A = 0.5f;
+	static constexpr float DEFAULT_SPEED = 0.5f;
+	static constexpr float STIFFNESS = 2.0f; // rough size of the jacobian on the attractor
+	static constexpr float BOUND = 25.0f; // well outside every orbit over the shape range
+	static constexpr float TOLERANCE = 1e-3f; // adaptive integrator error per step
+
+	TSprottLinzFAttractor() :
+		a(DEFAULT_A), speed(DEFAULT_SPEED),
+		x(0.1f), y(0.0f), z(0.0f) {}
+
+	T &shape() { return a; } // variable behind the shape knob
+	static const char *name() { return "sprottlinzf"; } // key in res/trajectories.bin
+
+	// right-hand side of the equations at (x, y, z)
+	void derive(T x, T y, T z, T &dx, T &dy, T &dz) const {
+		dx = y + z;
+		dy = -x + a * y;
+		dz = x * x - z;
+	}
+
+	void process(float dt) {
+		stepAttractor<EulerIntegrator>(*this, dt);
+	}
+};
+
+typedef TSprottLinzFAttractor<> SprottLinzFAttractor;
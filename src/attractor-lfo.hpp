@@ -0,0 +1,1147 @@
+// shared engine for the 2hp chaotic lfo series
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "anomalies.hpp"
+#include "lockfree.hpp"
+#include "trajectory-table.hpp"
+
+// maps res/trajectories.bin on first use, see trajectories.cpp
+bool loadTrajectoryTable(const char *name, TrajectoryTable &table);
+
+// work for the background thread that renders ahead, see prerender.cpp. a
+// plain function pointer rather than a virtual, the worker may still be
+// calling it while a module's destructor takes it off the list
+struct PrerenderJob {
+	void (*run)(PrerenderJob *job) = nullptr; // called on the worker thread
+};
+
+void addPrerenderJob(PrerenderJob *job);
+void removePrerenderJob(PrerenderJob *job);
+// from the engine thread, for a pass over the jobs soon. never waits for one
+void wakePrerenderWorker();
+
+template <>
+struct LaneOps<simd::float_4> {
+	typedef simd::float_4 Mask;
+
+	static float max(simd::float_4 v) {
+		// keeps nan, so error checks on a diverged lane still fail
+		float m = v[0];
+		for (int i = 1; i < 4; i++)
+			m = (v[i] > m || v[i] != v[i]) ? v[i] : m;
+		return m;
+	}
+
+	static Mask within(simd::float_4 v, float bound) { return simd::fabs(v) < bound; }
+	static simd::float_4 select(Mask m, simd::float_4 a, simd::float_4 b) { return simd::ifelse(m, a, b); }
+	static bool all(Mask m) { return simd::movemask(m) == 0xf; }
+};
+
+// settings shared by all 2hp attractor modules, kept out of the template so
+// the widgets can reach them without knowing the attractor type
+struct AttractorLfoBase : Module, PrerenderJob {
+	enum ParamIds {
+		SPEED_PARAM,
+		SHAPE_PARAM,
+		AMP_PARAM,
+		NUM_PARAMS
+	};
+	enum InputIds {
+		NUM_INPUTS
+	};
+	enum OutputIds {
+		X_OUTPUT,
+		Y_OUTPUT,
+		Z_OUTPUT,
+		T_OUTPUT,
+		NUM_OUTPUTS
+	};
+	enum LightIds {
+		NUM_LIGHTS
+	};
+
+	static constexpr int MAX_CHANNELS = 16;
+	static constexpr float SPEED_PARAM_MIN = 0.001f;
+	static constexpr float SPEED_PARAM_MAX = 1.0f;
+	static constexpr float AMP_PARAM_MIN = 0.1f;
+	static constexpr float AMP_PARAM_MAX = 10.0f;
+	static constexpr float AMP_PARAM_DEFAULT = 5.0f; // ±5v bipolar CV
+	static constexpr float OUTPUT_LIMIT = 12.f; // rail for the fixed scaling, also catches a voice between divergence checks
+	static constexpr int AUTO_INTEGRATOR = NUM_INTEGRATORS; // pick per step size
+	static constexpr float CONTROL_RATE = 1500.f; // attractor steps per second when not at audio rate
+
+	enum RateIds {
+		AUDIO_RATE,
+		LINEAR_CONTROL_RATE,
+		CUBIC_CONTROL_RATE,
+		NUM_RATES
+	};
+
+	int channels = 1; // polyphonic voices, each running its own copy of the attractor
+	int integrator = AUTO_INTEGRATOR; // IntegratorIds or AUTO_INTEGRATOR
+	int rate = CUBIC_CONTROL_RATE;
+	bool playback = false; // read the precomputed trajectory instead of integrating
+	bool normalize = false; // track each output's range and map it onto ±scale
+	bool sharing = false; // run one engine for all instances with the same settings
+	bool prerender = false; // render ahead on the background thread
+
+	float sampleRate = 44100.f;
+	bool normalizersDirty = true;
+	unsigned long rejectedSteps = 0; // copied from the engine each block, for the menu
+	unsigned long underruns = 0; // blocks the background thread didn't have ready
+
+	virtual void resetVoices() = 0;
+	virtual bool loadTable() = 0;
+	virtual void setPrerender(bool prerender) = 0;
+	virtual void setSharing(bool sharing) = 0;
+
+	void setRate(int rate) {
+		this->rate = rate;
+	}
+
+	// only switches to playback if the table could be loaded
+	void setPlayback(bool playback) {
+		this->playback = playback && loadTable();
+	}
+
+	// starts over from the fixed scaling's range
+	void setNormalize(bool normalize) {
+		this->normalize = normalize;
+		normalizersDirty = true;
+	}
+
+	void onSampleRateChange(const SampleRateChangeEvent &e) override {
+		sampleRate = e.sampleRate;
+	}
+
+	void onReset() override {
+		channels = 1;
+		integrator = AUTO_INTEGRATOR;
+		setRate(CUBIC_CONTROL_RATE);
+		setPlayback(false);
+		setNormalize(false);
+		setSharing(false);
+		setPrerender(false);
+		resetVoices();
+	}
+
+	json_t *dataToJson() override {
+		json_t *rootJ = json_object();
+		json_object_set_new(rootJ, "channels", json_integer(channels));
+		json_object_set_new(rootJ, "integrator", json_integer(integrator));
+		json_object_set_new(rootJ, "rate", json_integer(rate));
+		json_object_set_new(rootJ, "playback", json_boolean(playback));
+		json_object_set_new(rootJ, "normalize", json_boolean(normalize));
+		json_object_set_new(rootJ, "sharing", json_boolean(sharing));
+		json_object_set_new(rootJ, "prerender", json_boolean(prerender));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t *rootJ) override {
+		json_t *channelsJ = json_object_get(rootJ, "channels");
+		if (channelsJ)
+			channels = clamp((int) json_integer_value(channelsJ), 1, MAX_CHANNELS);
+
+		json_t *integratorJ = json_object_get(rootJ, "integrator");
+		if (integratorJ)
+			integrator = clamp((int) json_integer_value(integratorJ), 0, (int) AUTO_INTEGRATOR);
+
+		// patches from before control rate keep running at audio rate
+		json_t *rateJ = json_object_get(rootJ, "rate");
+		setRate(rateJ ? clamp((int) json_integer_value(rateJ), 0, NUM_RATES - 1) : (int) AUDIO_RATE);
+
+		json_t *playbackJ = json_object_get(rootJ, "playback");
+		if (playbackJ)
+			setPlayback(json_boolean_value(playbackJ));
+
+		json_t *normalizeJ = json_object_get(rootJ, "normalize");
+		if (normalizeJ)
+			setNormalize(json_boolean_value(normalizeJ));
+
+		json_t *sharingJ = json_object_get(rootJ, "sharing");
+		if (sharingJ)
+			setSharing(json_boolean_value(sharingJ));
+
+		json_t *prerenderJ = json_object_get(rootJ, "prerender");
+		if (prerenderJ)
+			setPrerender(json_boolean_value(prerenderJ));
+	}
+};
+
+// everything that decides what an engine renders, so engines with equal
+// settings and a common start render the same voices
+struct EngineSettings {
+	float shape = 0.f;
+	float speed = 0.f;
+	float sampleRate = 0.f;
+	int channels = 1;
+	int integrator = AttractorLfoBase::AUTO_INTEGRATOR;
+	int rate = AttractorLfoBase::CUBIC_CONTROL_RATE;
+	bool playback = false;
+
+	bool operator==(const EngineSettings &o) const {
+		return shape == o.shape && speed == o.speed && sampleRate == o.sampleRate && channels == o.channels
+			&& integrator == o.integrator && rate == o.rate && playback == o.playback;
+	}
+
+	bool operator!=(const EngineSettings &o) const {
+		return !(*this == o);
+	}
+};
+
+// the voices of one 2hp module: integrates or plays back the attractor and
+// renders raw x, y, z and t a block at a time, leaving scaling to the module
+template <template <typename> class TAttractor>
+struct AttractorEngine {
+	static constexpr int NUM_OUTPUTS = AttractorLfoBase::NUM_OUTPUTS;
+	static constexpr int MAX_GROUPS = AttractorLfoBase::MAX_CHANNELS / 4;
+	static constexpr float VOICE_SPREAD = 0.5f; // attractor time between neighbouring voices
+	static constexpr int VOICE_WARMUP_STEPS = 256;
+	static constexpr int BLOCK_SIZE = 32; // samples rendered ahead at a time
+	static constexpr float TABLE_VOICE_SPREAD = 0.618034f; // loop fraction between neighbouring voices
+
+	EngineSettings settings;
+
+	// four voices per float_4, so 16 voices update in 4 vector steps
+	TAttractor<simd::float_4> attractors[MAX_GROUPS];
+	TAdaptiveIntegrator<simd::float_4> adaptive[MAX_GROUPS];
+	TDivergenceGuard<TAttractor<simd::float_4>> guards[MAX_GROUPS];
+	int lastMethod = -1;
+	TControlCurve<simd::float_4> curves[MAX_GROUPS][3]; // x, y, z at control rate
+	bool curvesDirty = true;
+
+	// control rate timing, so the per-sample cost stays flat as the sample rate rises
+	float sampleTime = 1.f / 44100.f;
+	int controlDivision = 1; // samples per attractor step
+	float controlTime = 1.f / AttractorLfoBase::CONTROL_RATE; // seconds per attractor step
+	float controlPhaseStep = 1.f; // interpolation phase per sample
+	int controlPhase = 0;
+
+	// precomputed playback, a view on the shared mapping plus each voice's
+	// position along the loop in frames and the curve of its current frame
+	TrajectoryTable table;
+	bool tableLoaded = false;
+	float tableShape = -1.f;
+	simd::float_4 tablePhase[MAX_GROUPS];
+	simd::float_4 tableFrame[MAX_GROUPS]; // frame the coefficients are for, -1 when stale
+	simd::float_4 tableCoef[MAX_GROUPS][3][4];
+
+	// raw values of the last rendered block
+	simd::float_4 raw[BLOCK_SIZE][NUM_OUTPUTS][MAX_GROUPS];
+
+	AttractorEngine() {
+		for (int g = 0; g < MAX_GROUPS; g++)
+			adaptive[g].tolerance = TAttractor<float>::TOLERANCE;
+		setSampleRate(44100.f);
+		resetVoices();
+	}
+
+	void setSampleRate(float sampleRate) {
+		settings.sampleRate = sampleRate;
+		sampleTime = 1.f / sampleRate;
+		controlDivision = std::max((int) std::round(sampleRate / AttractorLfoBase::CONTROL_RATE), 1);
+		controlTime = controlDivision / sampleRate;
+		controlPhaseStep = 1.f / controlDivision;
+		controlPhase = 0;
+	}
+
+	void apply(const EngineSettings &s) {
+		if (s.sampleRate != settings.sampleRate)
+			setSampleRate(s.sampleRate);
+		if (s.rate != settings.rate || s.playback != settings.playback)
+			curvesDirty = true;
+		if (s.playback && !tableLoaded) {
+			tableLoaded = loadTrajectoryTable(TAttractor<float>::name(), table);
+			resetTablePhases();
+		}
+		settings = s;
+		settings.playback = s.playback && tableLoaded;
+	}
+
+	void resetVoices() {
+		for (int g = 0; g < MAX_GROUPS; g++) {
+			attractors[g] = TAttractor<simd::float_4>();
+			// stagger the voices along the trajectory so they start decorrelated,
+			// voice 0 keeps the attractor's own starting point
+			simd::float_4 voice = simd::float_4(0.f, 1.f, 2.f, 3.f) + 4.f * g;
+			attractors[g].speed = simd::sqrt(voice * (VOICE_SPREAD / VOICE_WARMUP_STEPS));
+			for (int i = 0; i < VOICE_WARMUP_STEPS; i++)
+				stepAttractor<Rk4Integrator>(attractors[g], 1.f);
+			guards[g].reset(attractors[g]);
+			adaptive[g].reset();
+		}
+		resetTablePhases();
+		curvesDirty = true;
+	}
+
+	void resetTablePhases() {
+		for (int g = 0; g < MAX_GROUPS; g++) {
+			simd::float_4 spread = (simd::float_4(0.f, 1.f, 2.f, 3.f) + 4.f * g) * TABLE_VOICE_SPREAD;
+			tablePhase[g] = (spread - simd::floor(spread)) * table.frames;
+			tableFrame[g] = -1.f;
+		}
+	}
+
+	unsigned long getRejectedSteps() const {
+		unsigned long rejected = 0;
+		for (int g = 0; g < MAX_GROUPS; g++)
+			rejected += adaptive[g].rejected;
+		return rejected;
+	}
+
+	// fixed step integrators are stateless policies
+	template <class TIntegrator>
+	void stepGroup(int g, TAttractor<simd::float_4> &a, float dt, TIntegrator) {
+		stepAttractor<TIntegrator>(a, dt);
+		guards[g].step(a);
+	}
+
+	// the adaptive one keeps its current step per voice group
+	void stepGroup(int g, TAttractor<simd::float_4> &a, float dt, AdaptiveIntegrator) {
+		adaptive[g].advance(a, dt);
+		if (guards[g].step(a))
+			adaptive[g].reset();
+	}
+
+	void renderOutputs(int i, int g, simd::float_4 x, simd::float_4 y, simd::float_4 z) {
+		raw[i][AttractorLfoBase::X_OUTPUT][g] = x;
+		raw[i][AttractorLfoBase::Y_OUTPUT][g] = y;
+		raw[i][AttractorLfoBase::Z_OUTPUT][g] = z;
+		raw[i][AttractorLfoBase::T_OUTPUT][g] = x + y - z; // mystery 4th dimension
+	}
+
+	// one attractor step per sample
+	template <class TIntegrator>
+	void renderAudioRate() {
+		for (int c = 0; c < settings.channels; c += 4) {
+			TAttractor<simd::float_4> a = attractors[c / 4];
+			a.shape() = settings.shape;
+			a.speed = settings.speed;
+			for (int i = 0; i < BLOCK_SIZE; i++) {
+				stepGroup(c / 4, a, sampleTime, TIntegrator());
+				renderOutputs(i, c / 4, a.x, a.y, a.z);
+			}
+			attractors[c / 4] = a;
+		}
+	}
+
+	// one attractor step every controlDivision samples with a longer dt,
+	// interpolated in between
+	template <class TIntegrator>
+	void renderControlRate() {
+		bool cubic = (settings.rate == AttractorLfoBase::CUBIC_CONTROL_RATE);
+		for (int c = 0; c < settings.channels; c += 4) {
+			TAttractor<simd::float_4> a = attractors[c / 4];
+			TControlCurve<simd::float_4> *curve = curves[c / 4];
+			a.shape() = settings.shape;
+			a.speed = settings.speed;
+			int phase = controlPhase;
+			for (int i = 0; i < BLOCK_SIZE; i++) {
+				if (phase == 0) {
+					stepGroup(c / 4, a, controlTime, TIntegrator());
+					curve[0].push(a.x, cubic);
+					curve[1].push(a.y, cubic);
+					curve[2].push(a.z, cubic);
+				}
+				float t = phase * controlPhaseStep;
+				renderOutputs(i, c / 4, curve[0].eval(t), curve[1].eval(t), curve[2].eval(t));
+				if (++phase >= controlDivision)
+					phase = 0;
+			}
+			attractors[c / 4] = a;
+		}
+		controlPhase = (controlPhase + BLOCK_SIZE) % controlDivision;
+	}
+
+	// the table is only read when a voice moves on to the next frame, otherwise
+	// each sample is a cubic per coordinate. the integrator settings don't apply
+	void renderTable() {
+		float shapePos = table.shapePosition(settings.shape);
+		if (shapePos != tableShape) {
+			tableShape = shapePos;
+			for (int g = 0; g < MAX_GROUPS; g++)
+				tableFrame[g] = -1.f;
+		}
+		float frames = table.frames;
+		simd::float_4 phaseStep = sampleTime * settings.speed * settings.speed / table.entry->timeStep;
+		for (int c = 0; c < settings.channels; c += 4) {
+			simd::float_4 phase = tablePhase[c / 4];
+			simd::float_4 &lastFrame = tableFrame[c / 4];
+			simd::float_4 (*coef)[4] = tableCoef[c / 4];
+			for (int i = 0; i < BLOCK_SIZE; i++) {
+				simd::float_4 frame = simd::floor(phase);
+				int stale = simd::movemask(frame != lastFrame);
+				for (int k = 0; stale; k++, stale >>= 1) {
+					if (!(stale & 1))
+						continue;
+					float laneCoef[3][4];
+					table.segment(shapePos, (int) frame[k], laneCoef);
+					for (int d = 0; d < 3; d++)
+						for (int j = 0; j < 4; j++)
+							coef[d][j][k] = laneCoef[d][j];
+				}
+				lastFrame = frame;
+				simd::float_4 t = phase - frame;
+				simd::float_4 out[3];
+				for (int d = 0; d < 3; d++)
+					out[d] = ((coef[d][3] * t + coef[d][2]) * t + coef[d][1]) * t + coef[d][0];
+				renderOutputs(i, c / 4, out[0], out[1], out[2]);
+				phase += phaseStep;
+				phase = simd::ifelse(phase >= frames, phase - frames, phase);
+			}
+			tablePhase[c / 4] = phase;
+		}
+	}
+
+	template <class TIntegrator>
+	void renderBlock() {
+		if (settings.rate == AttractorLfoBase::AUDIO_RATE)
+			renderAudioRate<TIntegrator>();
+		else
+			renderControlRate<TIntegrator>();
+	}
+
+	void render() {
+		if (settings.playback) {
+			renderTable();
+			return;
+		}
+
+		if (curvesDirty) {
+			curvesDirty = false;
+			for (int g = 0; g < MAX_GROUPS; g++) {
+				curves[g][0].reset(attractors[g].x);
+				curves[g][1].reset(attractors[g].y);
+				curves[g][2].reset(attractors[g].z);
+			}
+		}
+
+		int method = settings.integrator;
+		if (method == AttractorLfoBase::AUTO_INTEGRATOR) {
+			float dt = (settings.rate == AttractorLfoBase::AUDIO_RATE) ? sampleTime : controlTime;
+			method = chooseIntegrator(dt * settings.speed * settings.speed, TAttractor<float>::STIFFNESS);
+		}
+		if (method != lastMethod) {
+			// the adaptive integrator's pending step is stale after running another one
+			lastMethod = method;
+			for (int g = 0; g < MAX_GROUPS; g++)
+				adaptive[g].reset();
+		}
+		switch (method) {
+			case SEMI_IMPLICIT_EULER_INTEGRATOR: renderBlock<SemiImplicitEulerIntegrator>(); break;
+			case HEUN_INTEGRATOR: renderBlock<HeunIntegrator>(); break;
+			case RK4_INTEGRATOR: renderBlock<Rk4Integrator>(); break;
+			case ADAPTIVE_INTEGRATOR: renderBlock<AdaptiveIntegrator>(); break;
+			default: renderBlock<EulerIntegrator>(); break;
+		}
+	}
+};
+
+// engine sharing: instances of one attractor type with sharing switched on
+// and equal settings subscribe to one engine, which renders each block once
+// for all of them. blocks are numbered by engine frame, so every subscriber
+// asks for the same block in the same frame, whichever thread it runs on.
+// the registry is only ever locked off the engine thread, by the background
+// worker on a module's behalf or by a destructor, so engines are allocated
+// and freed there too. a lone subscriber keeps its engine when its settings
+// change, so turning a knob doesn't allocate unless it splits an instance
+// off a shared engine
+//
+// nothing on the engine thread locks. the first subscriber to ask for a
+// block claims the engine and renders it, the others read it, and only one
+// that asks while it's being rendered waits for it. copying the voices out
+// claims it the same way. the voices only change otherwise while the
+// engine isn't joinable, when its one subscriber fills it or retunes it
+template <template <typename> class TAttractor>
+struct EngineRegistry {
+	typedef AttractorEngine<TAttractor> Engine;
+
+	struct SharedEngine : Engine {
+		// registry side, under its lock. the settings it was asked for, which
+		// apply() may have toned down, say when the table is missing
+		int subscribers = 0;
+		EngineSettings key;
+
+		std::atomic<bool> joinable; // while nobody but its one subscriber can touch it
+		std::atomic<int64_t> renderState; // twice the last block rendered, plus one while claimed
+		std::atomic<uint32_t> resets; // asked for by any subscriber
+		uint32_t appliedResets = 0; // and carried out, by whoever rendered
+
+		SharedEngine() : joinable(false), renderState(-2), resets(0) {}
+
+		// other subscribers may be about to render it on their threads
+		void copyTo(Engine &engine) {
+			int64_t state = claim();
+			engine = *this;
+			renderState.store(state, std::memory_order_release);
+		}
+
+		// a new engine carries on from its first subscriber's voices, a
+		// retuned one from its own. either way the subscriber is alone on
+		// it, others only join once this is done
+		void fill(const Engine &engine, const EngineSettings &settings) {
+			Engine::operator=(engine);
+			retune(settings);
+		}
+
+		void retune(const EngineSettings &settings) {
+			Engine::apply(settings);
+			joinable.store(true, std::memory_order_release);
+		}
+
+		// the voices start over at the next block rendered, for everyone
+		void requestReset() {
+			resets.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// waits out a claim from another thread, if any, and returns the
+		// state to put back
+		int64_t claim() {
+			int64_t state = renderState.load(std::memory_order_acquire);
+			for (;;) {
+				if (state & 1) {
+					std::this_thread::yield();
+					state = renderState.load(std::memory_order_acquire);
+				}
+				else if (renderState.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_acquire)) {
+					return state;
+				}
+			}
+		}
+
+		void render(int64_t blockNumber) {
+			int64_t done = 2 * blockNumber;
+			if (renderState.load(std::memory_order_acquire) >= done)
+				return;
+			int64_t state = claim();
+			if (state < done) {
+				uint32_t asked = resets.load(std::memory_order_relaxed);
+				if (asked != appliedResets) {
+					appliedResets = asked;
+					Engine::resetVoices();
+				}
+				Engine::render();
+				state = done;
+			}
+			renderState.store(state, std::memory_order_release);
+		}
+	};
+
+	std::mutex mutex;
+	std::vector<SharedEngine*> engines;
+
+	static EngineRegistry &get() {
+		static EngineRegistry registry;
+		return registry;
+	}
+
+	// a subscription to the engine for the settings, for a subscriber now on
+	// current or on its own engine. current keeps its subscription even when
+	// it's the one returned, the subscriber lets go of it once it has moved
+	// over. fresh says a new engine was made, which the subscriber fills
+	// with its own voices before anyone else can join
+	SharedEngine *subscribe(SharedEngine *current, const EngineSettings &settings, bool &fresh) {
+		std::lock_guard<std::mutex> lock(mutex);
+		fresh = false;
+		for (SharedEngine *engine : engines) {
+			if (engine != current && engine->key == settings && engine->joinable.load(std::memory_order_acquire)) {
+				engine->subscribers++;
+				return engine;
+			}
+		}
+		if (current && current->subscribers == 1) {
+			// the subscriber retunes it when the answer comes, meanwhile
+			// nobody joins on the strength of the new key
+			current->joinable.store(false, std::memory_order_relaxed);
+			current->key = settings;
+			current->subscribers++;
+			return current;
+		}
+		SharedEngine *engine = new SharedEngine();
+		engine->apply(settings);
+		engine->key = settings;
+		engine->subscribers = 1;
+		engines.push_back(engine);
+		fresh = true;
+		return engine;
+	}
+
+	void unsubscribe(SharedEngine *engine) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!engine || --engine->subscribers > 0)
+			return;
+		engines.erase(std::find(engines.begin(), engines.end(), engine));
+		delete engine;
+	}
+};
+
+template <template <typename> class TAttractor>
+struct AttractorLfo : AttractorLfoBase {
+	typedef AttractorEngine<TAttractor> Engine;
+	typedef EngineRegistry<TAttractor> Registry;
+	static constexpr int MAX_GROUPS = Engine::MAX_GROUPS;
+	static constexpr int BLOCK_SIZE = Engine::BLOCK_SIZE;
+	static constexpr float RANGE_RELAX_TIME = 50.f; // attractor time for a normalized range to shrink by 1/e
+	static constexpr float RANGE_MEAN_TIME = 10.f; // attractor time constant of the centre it shrinks towards
+	static constexpr float PRERENDER_TIME = 0.02f; // lookahead, s
+	static constexpr int PRERENDER_BLOCKS = 128; // room for it up to 192 kHz
+
+	typedef typename Registry::SharedEngine SharedEngine;
+
+	Engine ownEngine;
+	SharedEngine *sharedEngine = nullptr; // while sharing
+	EngineSettings sharedSettings; // what it was asked for
+	uint32_t resets = 0; // voice resets asked for
+	uint32_t appliedResets = 0; // and carried out on the engine
+
+	// sharing: the engine thread never locks the registry. it asks the
+	// background worker for an engine, one request at a time, and keeps
+	// rendering what it has until the answer comes back. every answer holds
+	// a subscription of its own, and engines the module is done with are
+	// handed back to the worker to let go of. a ring holds at most a
+	// request and the two engines dropped since the worker last came by
+	struct SharingRequest {
+		EngineSettings settings;
+		SharedEngine *engine; // the one it's on now, or the one to let go
+		bool join;
+	};
+	struct SharingAnswer {
+		EngineSettings settings;
+		SharedEngine *engine;
+		bool fresh;
+	};
+	SpscRing<SharingRequest, 8> sharingRequests;
+	SpscRing<SharingAnswer, 8> sharingAnswers;
+	bool sharingAsked = false; // engine thread side
+	bool jobRegistered = false;
+
+	// pre-rendering: the own engine belongs to the background thread while
+	// engineOwner says so. settings and resets go to it through one ring and
+	// rendered blocks come back through another, neither side ever waits
+	enum EngineOwners {
+		AUDIO_OWNS,
+		WORKER_OWNS,
+		RETURNING // to the engine thread, once the worker lets go
+	};
+	struct PrerenderRequest {
+		EngineSettings settings;
+		uint32_t resets;
+	};
+	struct PrerenderedBlock {
+		int channels;
+		simd::float_4 raw[BLOCK_SIZE][NUM_OUTPUTS][MAX_GROUPS];
+	};
+	std::atomic<int> engineOwner;
+	std::unique_ptr<SpscRing<PrerenderRequest, 8>> requests;
+	std::unique_ptr<SpscRing<PrerenderedBlock, PRERENDER_BLOCKS>> prerendered;
+	bool prerenderRegistered = false;
+	bool priming = false; // the engine thread fills the ring before handing over
+	PrerenderRequest lastRequest; // engine thread side
+	bool lastRequestValid = false;
+	uint32_t workerResets = 0; // worker side
+	bool workerReady = false;
+
+	// rendered output voltages, served one sample per process() call.
+	// knob and channel changes take effect at the next block
+	simd::float_4 block[BLOCK_SIZE][NUM_OUTPUTS][MAX_GROUPS];
+	int64_t blockNumber = -1;
+	int blockChannels = 1;
+
+	TRangeNormalizer<simd::float_4> normalizers[NUM_OUTPUTS][MAX_GROUPS];
+
+	float speed = 0.f;
+	float amplitude = 0.f;
+	float scale = 0.f; // knob volts, the normalized outputs' peak
+
+	float shapeMin = 0.f;
+	float shapeMax = 1.f;
+	float speedFactor = 1.f; // speed knob to attractor speed
+	float ampFactor = 0.2f; // scale knob to amplitude
+	float outputGain[NUM_OUTPUTS] = {1.f, 1.f, 1.f, 1.f};
+	float outputOffset[NUM_OUTPUTS] = {};
+
+	AttractorLfo() : engineOwner(AUDIO_OWNS) {
+		run = [](PrerenderJob *job) {
+			AttractorLfo *lfo = static_cast<AttractorLfo*>(job);
+			lfo->answerSharing();
+			lfo->renderAhead();
+		};
+		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+		configOutput(X_OUTPUT, "x");
+		configOutput(Y_OUTPUT, "y");
+		configOutput(Z_OUTPUT, "z");
+		configOutput(T_OUTPUT, "t factor");
+		// held when pre-rendering falls behind before its first block
+		for (int i = 0; i < BLOCK_SIZE; i++)
+			for (int o = 0; o < NUM_OUTPUTS; o++)
+				for (int g = 0; g < MAX_GROUPS; g++)
+					block[i][o][g] = 0.f;
+	}
+
+	~AttractorLfo() {
+		// waits for the worker to be done with this module, then lets go of
+		// every engine still on the way in either direction
+		if (jobRegistered)
+			removePrerenderJob(this);
+		SharingRequest request;
+		while (sharingRequests.pop(request)) {
+			if (!request.join)
+				Registry::get().unsubscribe(request.engine);
+		}
+		SharingAnswer answer;
+		while (sharingAnswers.pop(answer))
+			Registry::get().unsubscribe(answer.engine);
+		if (sharedEngine)
+			Registry::get().unsubscribe(sharedEngine);
+	}
+
+	void configLfo(float shapeMin, float shapeMax, float shapeDefault, float speedFactor, float ampFactor) {
+		this->shapeMin = shapeMin;
+		this->shapeMax = shapeMax;
+		this->speedFactor = speedFactor;
+		this->ampFactor = ampFactor;
+		configParam(SPEED_PARAM, SPEED_PARAM_MIN, SPEED_PARAM_MAX, TAttractor<float>::DEFAULT_SPEED, "speed");
+		configParam(SHAPE_PARAM, shapeMin, shapeMax, shapeDefault, "shape");
+		configParam(AMP_PARAM, AMP_PARAM_MIN, AMP_PARAM_MAX, AMP_PARAM_DEFAULT, "scale");
+	}
+
+	// output voltage is (gain * value + offset) * amplitude
+	void configScaling(int outputId, float gain, float offset) {
+		outputGain[outputId] = gain;
+		outputOffset[outputId] = offset;
+	}
+
+	Engine &engine() {
+		return sharedEngine ? *sharedEngine : ownEngine;
+	}
+
+	// carried out by whichever thread renders next. a shared engine starts
+	// over for all its subscribers at once
+	void resetVoices() override {
+		resets++;
+		normalizersDirty = true;
+	}
+
+	void registerJob() {
+		if (!jobRegistered) {
+			addPrerenderJob(this);
+			jobRegistered = true;
+		}
+	}
+
+	// the rings and the worker are only set up the first time it's switched on
+	void setPrerender(bool prerender) override {
+		if (prerender && !prerenderRegistered) {
+			requests.reset(new SpscRing<PrerenderRequest, 8>());
+			prerendered.reset(new SpscRing<PrerenderedBlock, PRERENDER_BLOCKS>());
+			prerenderRegistered = true;
+			registerJob();
+		}
+		this->prerender = prerender;
+	}
+
+	// the worker looks engines up for the module from then on
+	void setSharing(bool sharing) override {
+		if (sharing)
+			registerJob();
+		this->sharing = sharing;
+	}
+
+	// the engines load their own view when they switch to playback
+	bool loadTable() override {
+		TrajectoryTable table;
+		return loadTrajectoryTable(TAttractor<float>::name(), table);
+	}
+
+	// seeds the running ranges with the raw range the fixed scaling maps to
+	// ±scale, so switching over doesn't jump
+	void resetNormalizers() {
+		for (int o = 0; o < NUM_OUTPUTS; o++) {
+			float peak = 1.f / ampFactor;
+			float lo = (-peak - outputOffset[o]) / outputGain[o];
+			float hi = (peak - outputOffset[o]) / outputGain[o];
+			for (int g = 0; g < MAX_GROUPS; g++)
+				normalizers[o][g].reset(lo, hi);
+		}
+	}
+
+	// raw values to volts, one multiply-add per sample either way. normalized
+	// outputs update their range from the block's extremes first, so the
+	// block lands exactly on ±scale and the clamp only catches rounding.
+	// fixed ones clamp to the rail, which also turns a nan from a voice that
+	// diverged since its last check into a finite voltage
+	void scaleBlock(const simd::float_4 (*raw)[NUM_OUTPUTS][MAX_GROUPS]) {
+		int groups = (blockChannels + 3) / 4;
+		simd::float_4 gain[NUM_OUTPUTS][MAX_GROUPS];
+		simd::float_4 offset[NUM_OUTPUTS][MAX_GROUPS];
+		float limit = OUTPUT_LIMIT;
+		if (normalize) {
+			// sample by sample across all outputs and groups, so the min and
+			// max chains run side by side instead of one after another. the
+			// sample goes first, minps and maxps hand back the second operand
+			// when either is nan, so a nan sample leaves the extreme alone
+			simd::float_4 lo[NUM_OUTPUTS][MAX_GROUPS];
+			simd::float_4 hi[NUM_OUTPUTS][MAX_GROUPS];
+			for (int o = 0; o < NUM_OUTPUTS; o++) {
+				for (int g = 0; g < groups; g++) {
+					lo[o][g] = INFINITY;
+					hi[o][g] = -INFINITY;
+				}
+			}
+			for (int i = 0; i < BLOCK_SIZE; i++) {
+				for (int o = 0; o < NUM_OUTPUTS; o++) {
+					for (int g = 0; g < groups; g++) {
+						lo[o][g] = simd::fmin(raw[i][o][g], lo[o][g]);
+						hi[o][g] = simd::fmax(raw[i][o][g], hi[o][g]);
+					}
+				}
+			}
+			float blockTime = BLOCK_SIZE * speed * speed / sampleRate; // attractor time
+			float relax = std::min(blockTime / RANGE_RELAX_TIME, 1.f);
+			float smooth = std::min(blockTime / RANGE_MEAN_TIME, 1.f);
+			for (int o = 0; o < NUM_OUTPUTS; o++) {
+				for (int g = 0; g < groups; g++) {
+					TRangeNormalizer<simd::float_4> &n = normalizers[o][g];
+					// an infinite sample, or a lane of nothing but nans, would
+					// stay in the range for good, the range only relaxes then
+					simd::float_4 blockLo = simd::ifelse(simd::fabs(lo[o][g]) < INFINITY, lo[o][g], n.mean);
+					simd::float_4 blockHi = simd::ifelse(simd::fabs(hi[o][g]) < INFINITY, hi[o][g], n.mean);
+					n.push(blockLo, blockHi, relax, smooth);
+					gain[o][g] = n.gain * scale;
+					offset[o][g] = n.offset * scale;
+				}
+			}
+			limit = scale;
+		}
+		else {
+			for (int o = 0; o < NUM_OUTPUTS; o++) {
+				for (int g = 0; g < groups; g++) {
+					gain[o][g] = outputGain[o] * amplitude;
+					offset[o][g] = outputOffset[o] * amplitude;
+				}
+			}
+		}
+		for (int o = 0; o < NUM_OUTPUTS; o++)
+			for (int g = 0; g < groups; g++)
+				for (int i = 0; i < BLOCK_SIZE; i++)
+					block[i][o][g] = simd::clamp(raw[i][o][g] * gain[o][g] + offset[o][g], -limit, limit);
+	}
+
+	// hands an engine the module is done with to the worker. the ring
+	// always has room, see sharingRequests
+	void leaveShared(SharedEngine *engine) {
+		SharingRequest request;
+		request.engine = engine;
+		request.join = false;
+		sharingRequests.push(request);
+		wakePrerenderWorker();
+	}
+
+	// drops the shared engine for the own one, carrying the voices over
+	void leaveShared() {
+		sharedEngine->copyTo(ownEngine);
+		leaveShared(sharedEngine);
+		sharedEngine = nullptr;
+	}
+
+	// moves between the own engine and a shared one, carrying the voices
+	// over so that switching sharing on or off doesn't jump. the engine
+	// the worker found is taken up at the next block
+	void updateSharing(const EngineSettings &settings) {
+		SharingAnswer answer;
+		if (sharingAnswers.pop(answer)) {
+			sharingAsked = false;
+			if (!sharing) {
+				leaveShared(answer.engine);
+			}
+			else if (answer.engine == sharedEngine) {
+				// retuned where it was, one subscription is enough
+				answer.engine->retune(answer.settings);
+				leaveShared(answer.engine);
+				sharedSettings = answer.settings;
+			}
+			else {
+				// a new engine goes on from here, an existing one from
+				// wherever its subscribers are
+				if (answer.fresh) {
+					if (sharedEngine)
+						sharedEngine->copyTo(ownEngine);
+					answer.engine->fill(ownEngine, answer.settings);
+				}
+				if (sharedEngine)
+					leaveShared(sharedEngine);
+				sharedEngine = answer.engine;
+				sharedSettings = answer.settings;
+			}
+		}
+
+		if (sharing) {
+			if (!sharingAsked && (!sharedEngine || sharedSettings != settings)) {
+				SharingRequest request;
+				request.settings = settings;
+				request.engine = sharedEngine;
+				request.join = true;
+				sharingAsked = sharingRequests.push(request);
+				wakePrerenderWorker();
+			}
+		}
+		else if (sharedEngine) {
+			leaveShared();
+		}
+	}
+
+	// worker side: looks up or makes the engines asked for and lets go of
+	// the ones left
+	void answerSharing() {
+		SharingRequest request;
+		while (sharingRequests.pop(request)) {
+			if (!request.join) {
+				Registry::get().unsubscribe(request.engine);
+				continue;
+			}
+			SharingAnswer answer;
+			answer.settings = request.settings;
+			answer.engine = Registry::get().subscribe(request.engine, request.settings, answer.fresh);
+			sharingAnswers.push(answer);
+		}
+	}
+
+	// hands the own engine to the worker or asks for it back. a shared
+	// engine is left first, the worker only ever renders the own one. the
+	// engine thread primes the ring with half the lookahead first, a block
+	// per process() call, so the worker starts out with time to spare and no
+	// call renders more than a block. the outputs come from the ring all
+	// along, changes made meanwhile are queued for the worker
+	void updatePrerender(const EngineSettings &settings) {
+		int owner = engineOwner.load(std::memory_order_acquire);
+		if (prerender && prerenderRegistered && owner == AUDIO_OWNS && !priming) {
+			if (sharedEngine)
+				leaveShared();
+			if (appliedResets != resets) {
+				appliedResets = resets;
+				ownEngine.resetVoices();
+			}
+			ownEngine.apply(settings);
+			requests->clear();
+			prerendered->clear();
+			renderPrerendered(1);
+			lastRequest.settings = settings;
+			lastRequest.resets = resets;
+			lastRequestValid = true;
+			workerResets = resets;
+			workerReady = true;
+			priming = true;
+		}
+		else if (!prerender && priming) {
+			priming = false;
+		}
+		else if (!prerender && owner == WORKER_OWNS) {
+			engineOwner.store(RETURNING, std::memory_order_release);
+			wakePrerenderWorker();
+		}
+	}
+
+	// one more block into the ring, then the worker takes over once it's
+	// half full
+	void primePrerendered() {
+		int lookahead = prerenderBlocks(ownEngine.settings.sampleRate);
+		renderPrerendered((int) prerendered->size() + 1);
+		if ((int) prerendered->size() >= lookahead / 2) {
+			priming = false;
+			engineOwner.store(WORKER_OWNS, std::memory_order_release);
+			wakePrerenderWorker();
+		}
+	}
+
+	// blocks kept rendered ahead, the ring's room caps it above 192 kHz
+	static int prerenderBlocks(float sampleRate) {
+		return clamp((int) std::ceil(PRERENDER_TIME * sampleRate / BLOCK_SIZE), 2, PRERENDER_BLOCKS);
+	}
+
+	// engine thread side: sends changed settings and takes the next block,
+	// or holds the last sample if the worker hasn't caught up. the worker is
+	// woken with half the lookahead still to go, which leaves it 10 ms even
+	// when the host takes a few blocks at once
+	void takePrerendered(const EngineSettings &settings) {
+		PrerenderRequest request;
+		request.settings = settings;
+		request.resets = resets;
+		if (!lastRequestValid || request.settings != lastRequest.settings || request.resets != lastRequest.resets) {
+			if (requests->push(request)) {
+				lastRequest = request;
+				lastRequestValid = true;
+			}
+		}
+
+		if (!priming && prerendered->size() <= (size_t) prerenderBlocks(settings.sampleRate) / 2)
+			wakePrerenderWorker();
+
+		const PrerenderedBlock *rendered = prerendered->readSlot();
+		if (!rendered) {
+			underruns++;
+			for (int i = 0; i < BLOCK_SIZE - 1; i++)
+				for (int o = 0; o < NUM_OUTPUTS; o++)
+					for (int g = 0; g < MAX_GROUPS; g++)
+						block[i][o][g] = block[BLOCK_SIZE - 1][o][g];
+			return;
+		}
+		blockChannels = rendered->channels;
+		scaleBlock(rendered->raw);
+		prerendered->commitRead();
+	}
+
+	// worker side: applies what the engine thread sent, then tops up the ring
+	void renderAhead() {
+		int owner = engineOwner.load(std::memory_order_acquire);
+		if (owner == RETURNING) {
+			appliedResets = workerResets;
+			engineOwner.store(AUDIO_OWNS, std::memory_order_release);
+			return;
+		}
+		if (owner != WORKER_OWNS)
+			return;
+
+		PrerenderRequest request;
+		while (requests->pop(request)) {
+			if (request.resets != workerResets) {
+				workerResets = request.resets;
+				ownEngine.resetVoices();
+			}
+			ownEngine.apply(request.settings);
+			workerReady = true;
+		}
+		if (!workerReady)
+			return;
+		renderPrerendered(prerenderBlocks(ownEngine.settings.sampleRate));
+	}
+
+	// tops the ring up to the lookahead, on whichever side owns the engine
+	void renderPrerendered(int lookahead) {
+		while (prerendered->size() < (size_t) lookahead) {
+			PrerenderedBlock *slot = prerendered->writeSlot();
+			ownEngine.render();
+			slot->channels = ownEngine.settings.channels;
+			memcpy(slot->raw, ownEngine.raw, sizeof(slot->raw));
+			prerendered->commitWrite();
+		}
+	}
+
+	void renderBlock() {
+		EngineSettings settings;
+		settings.shape = clamp(params[SHAPE_PARAM].getValue(), shapeMin, shapeMax);
+		settings.speed = clamp(params[SPEED_PARAM].getValue(), SPEED_PARAM_MIN, SPEED_PARAM_MAX) * speedFactor;
+		settings.sampleRate = sampleRate;
+		settings.channels = channels;
+		settings.integrator = integrator;
+		settings.rate = rate;
+		settings.playback = playback;
+		speed = settings.speed;
+		scale = clamp(params[AMP_PARAM].getValue(), AMP_PARAM_MIN, AMP_PARAM_MAX);
+		amplitude = scale * ampFactor;
+
+		if (normalizersDirty) {
+			normalizersDirty = false;
+			resetNormalizers();
+		}
+
+		updatePrerender(settings);
+		if (priming || engineOwner.load(std::memory_order_acquire) != AUDIO_OWNS) {
+			takePrerendered(settings);
+			return;
+		}
+
+		updateSharing(settings);
+		if (appliedResets != resets) {
+			appliedResets = resets;
+			if (sharedEngine)
+				sharedEngine->requestReset();
+			else
+				ownEngine.resetVoices();
+		}
+		// a shared engine renders the channels it was asked for, until the
+		// worker's answer for a new count comes back
+		if (sharedEngine) {
+			sharedEngine->render(blockNumber);
+			blockChannels = std::min(channels, sharedEngine->settings.channels);
+		}
+		else {
+			ownEngine.apply(settings);
+			ownEngine.render();
+			blockChannels = channels;
+		}
+		rejectedSteps = engine().getRejectedSteps();
+		scaleBlock(engine().raw);
+	}
+
+	void process(const ProcessArgs &args) override {
+		if (!(outputs[X_OUTPUT].isConnected()
+			|| outputs[Y_OUTPUT].isConnected()
+			|| outputs[Z_OUTPUT].isConnected()
+			|| outputs[T_OUTPUT].isConnected()))
+			return;
+
+		// blocks follow the engine frame, so shared engines line up
+		int64_t frameBlock = args.frame / BLOCK_SIZE;
+		if (frameBlock != blockNumber) {
+			blockNumber = frameBlock;
+			renderBlock();
+		}
+		else if (priming) {
+			primePrerendered();
+		}
+		int blockIndex = args.frame % BLOCK_SIZE;
+		for (int i = 0; i < NUM_OUTPUTS; i++) {
+			for (int c = 0; c < blockChannels; c += 4)
+				outputs[i].setVoltageSimd(block[blockIndex][i][c / 4], c);
+			outputs[i].setChannels(blockChannels);
+		}
+	}
+};
+
+struct AttractorLfoWidget : ModuleWidget {
+	void appendContextMenu(Menu *menu) override {
+		AttractorLfoBase *lfo = dynamic_cast<AttractorLfoBase*>(module);
+		assert(lfo);
+		std::vector<std::string> channelLabels;
+		for (int c = 1; c <= AttractorLfoBase::MAX_CHANNELS; c++)
+			channelLabels.push_back(string::f("%d", c));
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexSubmenuItem("Polyphony channels", channelLabels,
+			[=]() { return lfo->channels - 1; },
+			[=](int index) { lfo->channels = index + 1; }
+		));
+		menu->addChild(createIndexPtrSubmenuItem("Integrator",
+			{"euler", "semi-implicit euler", "heun", "runge-kutta 4", "adaptive", "auto"},
+			&lfo->integrator
+		));
+		if (lfo->integrator == ADAPTIVE_INTEGRATOR || lfo->integrator == AttractorLfoBase::AUTO_INTEGRATOR)
+			menu->addChild(createMenuLabel(string::f("Adaptive steps rejected: %lu", lfo->rejectedSteps)));
+		menu->addChild(createIndexSubmenuItem("Integration rate",
+			{"audio rate", "control rate, linear", "control rate, cubic"},
+			[=]() { return lfo->rate; },
+			[=](int rate) { lfo->setRate(rate); }
+		));
+		menu->addChild(createBoolMenuItem("Play precomputed trajectory", "",
+			[=]() { return lfo->playback; },
+			[=](bool playback) { lfo->setPlayback(playback); }
+		));
+		menu->addChild(createBoolMenuItem("Normalize outputs to ±scale", "",
+			[=]() { return lfo->normalize; },
+			[=](bool normalize) { lfo->setNormalize(normalize); }
+		));
+		menu->addChild(createBoolMenuItem("Share engine with identical instances", "",
+			[=]() { return lfo->sharing; },
+			[=](bool sharing) { lfo->setSharing(sharing); }
+		));
+		menu->addChild(createBoolMenuItem("Render ahead on a background thread", "",
+			[=]() { return lfo->prerender; },
+			[=](bool prerender) { lfo->setPrerender(prerender); }
+		));
+		if (lfo->prerender)
+			menu->addChild(createMenuLabel(string::f("Blocks not ready in time: %lu", lfo->underruns)));
+	}
+};
@@ -1,79 +1,139 @@
-#include "anomalies.hpp"
-
-struct DualAttenuverter : Module {
-    enum ParamIds {
-		A_SCALE_PARAM,
-		A_OFFSET_PARAM,
-		B_SCALE_PARAM,
-		B_OFFSET_PARAM,
-	    NUM_PARAMS
-    };
-    enum InputIds {
-		A_INPUT,
-		B_INPUT,
-        NUM_INPUTS
-    };
-    enum OutputIds {
-		A_OUTPUT,
-		B_OUTPUT,
-        NUM_OUTPUTS
-    };
-    enum LightIds {
-        NUM_LIGHTS
-    };
-
-    DualAttenuverter() {
-        config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
-		configParam(A_SCALE_PARAM, -3.0f, 3.0f, 1.0f, "scale");
-		configParam(A_OFFSET_PARAM, -10.0f, 10.0f, 0.0f, "offset", " v");
-		configParam(B_SCALE_PARAM, -3.0f, 3.0f, 1.0f, "scale");
-		configParam(B_OFFSET_PARAM, -10.0f, 10.0f, 0.0f, "offset", " v");
-		configInput(A_INPUT, "a");
-		configInput(B_INPUT, "b");
-		configOutput(A_OUTPUT, "a");
-		configOutput(B_OUTPUT, "b");
-    }
-
-    void process(const ProcessArgs &args) override;
-};
-
-void DualAttenuverter::process(const ProcessArgs &args) {
-	if (outputs[A_OUTPUT].isConnected()) {
-		int a_channels = inputs[A_INPUT].getChannels(); // enable polyphony
-		for (int c = 0; c < a_channels; c++) {
-			float a_out = clamp(inputs[A_INPUT].getPolyVoltage(c) * params[A_SCALE_PARAM].getValue()
-						+ params[A_OFFSET_PARAM].getValue(), -12.0f, 12.0f);
-			outputs[A_OUTPUT].setVoltage(a_out, c);
-		}
-    	outputs[A_OUTPUT].setChannels(a_channels);
-	}
-	if (outputs[B_OUTPUT].isConnected()) {
-		int b_channels = inputs[B_INPUT].getChannels(); // enable polyphony
-		for (int c = 0; c < b_channels; c++) {
-			float b_out = clamp(inputs[B_INPUT].getPolyVoltage(c) * params[B_SCALE_PARAM].getValue()
-			+ params[B_OFFSET_PARAM].getValue(), -12.0f, 12.0f);
-			outputs[B_OUTPUT].setVoltage(b_out, c);
-		}
-		outputs[B_OUTPUT].setChannels(b_channels);
-	}
-}
-
-struct DualAttenuverterWidget : ModuleWidget {
-    DualAttenuverterWidget(DualAttenuverter *module) {
-        setModule(module);
-        box.size = Vec(2 * RACK_GRID_WIDTH, RACK_GRID_HEIGHT);
-		setPanel(createPanel(asset::plugin(pluginInstance, "res/face/2at.svg")));
-
-		addParam(createParam<KnobS>(Vec(4, 28), module, DualAttenuverter::A_SCALE_PARAM));
-		addParam(createParam<KnobS>(Vec(4, 68), module, DualAttenuverter::A_OFFSET_PARAM));
-		addInput(createInput<InPort>(Vec(5, 110), module, DualAttenuverter::A_INPUT));
-		addOutput(createOutput<OutPort>(Vec(5, 150), module, DualAttenuverter::A_OUTPUT));
-
-		addParam(createParam<KnobS>(Vec(4, 198), module, DualAttenuverter::B_SCALE_PARAM));
-		addParam(createParam<KnobS>(Vec(4, 238), module, DualAttenuverter::B_OFFSET_PARAM));
-		addInput(createInput<InPort>(Vec(5, 280), module, DualAttenuverter::B_INPUT));
-		addOutput(createOutput<OutPort>(Vec(5, 320), module, DualAttenuverter::B_OUTPUT));
-	}
-};
-
-Model *modelDualAttenuverter = createModel<DualAttenuverter, DualAttenuverterWidget>("2at");
+#include "anomalies.hpp"
+
+struct DualAttenuverter : Module {
+    enum ParamIds {
+		A_SCALE_PARAM,
+		A_OFFSET_PARAM,
+		B_SCALE_PARAM,
+		B_OFFSET_PARAM,
+	    NUM_PARAMS
+    };
+    enum InputIds {
+		A_INPUT,
+		B_INPUT,
+        NUM_INPUTS
+    };
+    enum OutputIds {
+		A_OUTPUT,
+		B_OUTPUT,
+        NUM_OUTPUTS
+    };
+    enum LightIds {
+        NUM_LIGHTS
+    };
+
+    DualAttenuverter() {
+        config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+		configParam(A_SCALE_PARAM, -3.0f, 3.0f, 1.0f, "scale");
+		configParam(A_OFFSET_PARAM, -10.0f, 10.0f, 0.0f, "offset", " v");
+		configParam(B_SCALE_PARAM, -3.0f, 3.0f, 1.0f, "scale");
+		configParam(B_OFFSET_PARAM, -10.0f, 10.0f, 0.0f, "offset", " v");
+		configInput(A_INPUT, "a");
+		configInput(B_INPUT, "b");
+		configOutput(A_OUTPUT, "a");
+		configOutput(B_OUTPUT, "b");
+    }
+
+    void attenuvert(Input &in, Output &out, int scaleParam, int offsetParam, Input *scaleCv, Input *offsetCv);
+    void process(const ProcessArgs &args) override;
+};
+
+// the cv expander, 2hp to the right of the attenuverter. it only carries the
+// jacks, the attenuverter reads them straight off it
+struct DualAttenuverterCv : Module {
+    enum InputIds {
+		A_SCALE_INPUT,
+		A_OFFSET_INPUT,
+		B_SCALE_INPUT,
+		B_OFFSET_INPUT,
+        NUM_INPUTS
+    };
+
+    DualAttenuverterCv() {
+        config(0, NUM_INPUTS, 0, 0);
+		configInput(A_SCALE_INPUT, "a scale cv");
+		configInput(A_OFFSET_INPUT, "a offset cv");
+		configInput(B_SCALE_INPUT, "b scale cv");
+		configInput(B_OFFSET_INPUT, "b offset cv");
+    }
+};
+
+// ±10v of scale cv sweeps the whole -3x to +3x range, offset cv adds on 1:1
+static const float SCALE_CV = 0.3f;
+
+// four channels at a time. a mono cv applies to every channel, a poly one
+// channel by channel. with the input unpatched the cvs alone set the channels
+void DualAttenuverter::attenuvert(Input &in, Output &out, int scaleParam, int offsetParam, Input *scaleCv, Input *offsetCv) {
+	simd::float_4 scale = params[scaleParam].getValue();
+	simd::float_4 offset = params[offsetParam].getValue();
+	if (!scaleCv) {
+		int channels = in.getChannels();
+		for (int c = 0; c < channels; c += 4) {
+			simd::float_4 v = in.getPolyVoltageSimd<simd::float_4>(c) * scale + offset;
+			out.setVoltageSimd(simd::clamp(v, -12.f, 12.f), c);
+		}
+		out.setChannels(channels);
+		return;
+	}
+	int channels = std::max(in.getChannels(), std::max(scaleCv->getChannels(), offsetCv->getChannels()));
+	for (int c = 0; c < channels; c += 4) {
+		simd::float_4 v = in.getPolyVoltageSimd<simd::float_4>(c) * (scale + scaleCv->getPolyVoltageSimd<simd::float_4>(c) * SCALE_CV)
+			+ offset + offsetCv->getPolyVoltageSimd<simd::float_4>(c);
+		out.setVoltageSimd(simd::clamp(v, -12.f, 12.f), c);
+	}
+	out.setChannels(channels);
+}
+
+void DualAttenuverter::process(const ProcessArgs &args) {
+	// input voltages only change between engine frames, so the expander's
+	// jacks can be read directly while it's being processed too
+	Module *expander = rightExpander.module;
+	bool cv = expander && expander->model == modelDualAttenuverterCv;
+	if (outputs[A_OUTPUT].isConnected()) {
+		attenuvert(inputs[A_INPUT], outputs[A_OUTPUT], A_SCALE_PARAM, A_OFFSET_PARAM,
+			cv ? &expander->inputs[DualAttenuverterCv::A_SCALE_INPUT] : nullptr,
+			cv ? &expander->inputs[DualAttenuverterCv::A_OFFSET_INPUT] : nullptr);
+	}
+	if (outputs[B_OUTPUT].isConnected()) {
+		attenuvert(inputs[B_INPUT], outputs[B_OUTPUT], B_SCALE_PARAM, B_OFFSET_PARAM,
+			cv ? &expander->inputs[DualAttenuverterCv::B_SCALE_INPUT] : nullptr,
+			cv ? &expander->inputs[DualAttenuverterCv::B_OFFSET_INPUT] : nullptr);
+	}
+}
+
+struct DualAttenuverterWidget : ModuleWidget {
+    DualAttenuverterWidget(DualAttenuverter *module) {
+        setModule(module);
+        box.size = Vec(2 * RACK_GRID_WIDTH, RACK_GRID_HEIGHT);
+		setPanel(createPanel(asset::plugin(pluginInstance, "res/face/2at.svg")));
+
+		addParam(createParam<KnobS>(Vec(4, 28), module, DualAttenuverter::A_SCALE_PARAM));
+		addParam(createParam<KnobS>(Vec(4, 68), module, DualAttenuverter::A_OFFSET_PARAM));
+		addInput(createInput<InPort>(Vec(5, 110), module, DualAttenuverter::A_INPUT));
+		addOutput(createOutput<OutPort>(Vec(5, 150), module, DualAttenuverter::A_OUTPUT));
+
+		addParam(createParam<KnobS>(Vec(4, 198), module, DualAttenuverter::B_SCALE_PARAM));
+		addParam(createParam<KnobS>(Vec(4, 238), module, DualAttenuverter::B_OFFSET_PARAM));
+		addInput(createInput<InPort>(Vec(5, 280), module, DualAttenuverter::B_INPUT));
+		addOutput(createOutput<OutPort>(Vec(5, 320), module, DualAttenuverter::B_OUTPUT));
+	}
+};
+
+Model *modelDualAttenuverter = createModel<DualAttenuverter, DualAttenuverterWidget>("2at");
+
+struct DualAttenuverterCvWidget : ModuleWidget {
+    DualAttenuverterCvWidget(DualAttenuverterCv *module) {
+        setModule(module);
+        box.size = Vec(2 * RACK_GRID_WIDTH, RACK_GRID_HEIGHT);
+		setPanel(createPanel(asset::plugin(pluginInstance, "res/face/2atcv.svg")));
+
+		// level with the knobs they add to
+		addInput(createInput<InPort>(Vec(5, 29), module, DualAttenuverterCv::A_SCALE_INPUT));
+		addInput(createInput<InPort>(Vec(5, 69), module, DualAttenuverterCv::A_OFFSET_INPUT));
+
+		addInput(createInput<InPort>(Vec(5, 199), module, DualAttenuverterCv::B_SCALE_INPUT));
+		addInput(createInput<InPort>(Vec(5, 239), module, DualAttenuverterCv::B_OFFSET_INPUT));
+	}
+};
+
+Model *modelDualAttenuverterCv = createModel<DualAttenuverterCv, DualAttenuverterCvWidget>("2atcv");
@@ -1,6 +1,300 @@
+#include <limits.h>
+#include <time.h>
 #include "anomalies.hpp"
+#include "lockfree.hpp"
+#include "minmax-pyramid.hpp"
+#include "recorder.hpp"
 
 #define BUFFER_SIZE 512
+#define PUBLISH_RATE 60 // captures handed to the display per second, at most
+#define STATS_SEGMENTS 8
+
+// time spans the statistics can describe, in seconds
+static const float STATS_SPANS[] = {0.1f, 1.f, 10.f};
+
+// 3d camera: how far it looks down on the figure in degrees, and how far
+// away it is in volts after scaling, nearer is more perspective
+static const float CAMERA_ELEVATIONS[] = {0.f, 15.f, 30.f, 45.f, 60.f, 90.f};
+static const float CAMERA_DISTANCES[] = {INFINITY, 40.f, 20.f};
+
+// trigger holdoff in seconds, and the part of a sweep before the trigger
+static const float HOLDOFF_TIMES[] = {0.f, 0.001f, 0.01f, 0.1f, 1.f};
+static const float PRETRIGGER_SPANS[] = {0.f, 0.1f, 0.25f, 0.5f};
+#define TRIGGER_HYSTERESIS 0.05f // volts back past the level before the next trigger
+#define AUTO_TRIGGER_TIME 0.1f // free runs after this long without a trigger
+
+// per channel statistics of both inputs, x then y
+struct ScopeStats {
+	float min[2][PORT_MAX_CHANNELS] = {};
+	float max[2][PORT_MAX_CHANNELS] = {};
+	float mean[2][PORT_MAX_CHANNELS] = {}; // the dc offset
+	float rms[2][PORT_MAX_CHANNELS] = {};
+	int channels = 1;
+};
+
+// one capture as the display gets it. the points are a ring and the ones
+// shown run from start, a whole sweep or the lissajous tail, or the part of
+// a slow sweep captured so far. each point holds all channels side by side,
+// so a poly sample goes in with a few simd stores
+struct ScopeCapture {
+	float x[BUFFER_SIZE][PORT_MAX_CHANNELS] = {};
+	float y[BUFFER_SIZE][PORT_MAX_CHANNELS] = {};
+	float z[BUFFER_SIZE][PORT_MAX_CHANNELS] = {};
+	int start = 0;
+	int points = 0;
+	float phase = 0.f; // of the trigger between two points, the sweep is shifted left by it
+	int channels = 1;
+	uint32_t revision = 0; // counts points shown
+	bool zeroZ = true; // z is all zeros, as it stays while nothing is patched there
+};
+
+// statistics of every sample of both inputs, in float_4 lanes of channels.
+// samples are summed up in segments an eighth of the span long. windowed,
+// the last STATS_SEGMENTS segments are combined, so the window slides an
+// eighth at a time. decaying, each segment moves exponential averages of
+// mean and mean square with the span as time constant, and the extremes
+// sink back towards the mean as fast. averaging segments rather than
+// samples keeps the tiny per sample steps from drowning in float rounding
+struct ScopeStatsAccumulator {
+	typedef simd::float_4 float_4;
+	static constexpr int GROUPS = PORT_MAX_CHANNELS / 4;
+
+	struct Moments {
+		float_4 min, max, sum, squares;
+
+		void reset() {
+			min = INFINITY;
+			max = -INFINITY;
+			sum = 0.f;
+			squares = 0.f;
+		}
+	};
+	Moments current[2][GROUPS];
+	Moments segments[STATS_SEGMENTS][2][GROUPS];
+	int segmentLength = 1;
+	int segmentSamples = 0;
+	int segment = 0;
+	int filled = 0; // full segments so far, up to STATS_SEGMENTS
+	Moments decayed[2][GROUPS]; // sum and squares hold mean and mean square
+	float coefficient = 0.f;
+
+	// what the statistics were started with
+	float span = 0.f;
+	float sampleRate = 0.f;
+	bool decaying = false;
+	int groups = 0;
+
+	// starts over when anything changed
+	void configure(float span, float sampleRate, bool decaying, int channels) {
+		int groups = (channels + 3) / 4;
+		if (span == this->span && sampleRate == this->sampleRate && decaying == this->decaying && groups == this->groups)
+			return;
+		this->span = span;
+		this->sampleRate = sampleRate;
+		this->decaying = decaying;
+		this->groups = groups;
+		segmentLength = std::max((int) (span * sampleRate / STATS_SEGMENTS), 1);
+		segmentSamples = 0;
+		segment = 0;
+		filled = 0;
+		coefficient = 1.f - std::exp(-(float) segmentLength / (span * sampleRate));
+		for (int i = 0; i < 2; i++)
+			for (int g = 0; g < GROUPS; g++)
+				current[i][g].reset();
+	}
+
+	void process(Input &x, Input &y) {
+		for (int i = 0; i < 2; i++) {
+			Input &input = i ? y : x;
+			for (int g = 0; g < groups; g++) {
+				float_4 v = input.getPolyVoltageSimd<float_4>(g * 4);
+				Moments &m = current[i][g];
+				m.min = simd::fmin(m.min, v);
+				m.max = simd::fmax(m.max, v);
+				m.sum += v;
+				m.squares += v * v;
+			}
+		}
+		if (++segmentSamples < segmentLength)
+			return;
+		segmentSamples = 0;
+
+		// a segment is full
+		float_4 k = filled ? coefficient : 1.f;
+		float_4 scale = 1.f / segmentLength;
+		for (int i = 0; i < 2; i++) {
+			for (int g = 0; g < groups; g++) {
+				Moments &m = current[i][g];
+				if (decaying) {
+					Moments &d = decayed[i][g];
+					d.sum += (m.sum * scale - d.sum) * k;
+					d.squares += (m.squares * scale - d.squares) * k;
+					d.min = filled ? simd::fmin(m.min, d.min + (d.sum - d.min) * k) : m.min;
+					d.max = filled ? simd::fmax(m.max, d.max + (d.sum - d.max) * k) : m.max;
+				}
+				else {
+					segments[segment][i][g] = m;
+				}
+				m.reset();
+			}
+		}
+		segment = (segment + 1) % STATS_SEGMENTS;
+		filled = std::min(filled + 1, STATS_SEGMENTS);
+	}
+
+	// the numbers as they stand, into a capture about to be published
+	void publish(ScopeStats &stats) {
+		for (int i = 0; i < 2; i++) {
+			for (int g = 0; g < groups; g++) {
+				Moments m;
+				float_4 count;
+				if (filled == 0) {
+					// not a whole segment yet
+					m = current[i][g];
+					count = (float) std::max(segmentSamples, 1);
+				}
+				else if (decaying) {
+					m = decayed[i][g];
+					count = 1.f;
+				}
+				else {
+					m = segments[0][i][g];
+					for (int k = 1; k < filled; k++) {
+						m.min = simd::fmin(m.min, segments[k][i][g].min);
+						m.max = simd::fmax(m.max, segments[k][i][g].max);
+						m.sum += segments[k][i][g].sum;
+						m.squares += segments[k][i][g].squares;
+					}
+					count = (float) (filled * segmentLength);
+				}
+				m.min.store(&stats.min[i][g * 4]);
+				m.max.store(&stats.max[i][g * 4]);
+				(m.sum / count).store(&stats.mean[i][g * 4]);
+				simd::sqrt(m.squares / count).store(&stats.rms[i][g * 4]);
+			}
+		}
+	}
+};
+
+// phosphor persistence, the time constant the density fades with in seconds
+static const float PERSISTENCE_TIMES[] = {0.1f, 0.5f, 2.f};
+#define DENSITY_SIZE 256 // cells across and down
+#define DENSITY_HIT 128 // what a sample adds to its cell
+
+// one fade of a density count, an eighth off rounded up. rounding down would
+// leave every count from 7 on stuck there for good, a ghost of every spot
+// the trace ever touched
+template <typename T>
+constexpr T densityFade(T v) {
+	return v - ((v + 7) >> 3);
+}
+
+constexpr bool densityFadesOut(int32_t v, int passes) {
+	return v == 0 || (passes > 0 && densityFadesOut(densityFade(v), passes - 1));
+}
+
+// the fullest cell goes dark in a couple of hundred passes over the grid
+static_assert(densityFadesOut(1 << 30, 200), "density counts must fade to 0");
+static_assert(densityFade(7) == 6 && densityFade(1) == 0, "density counts must fade to 0");
+
+// spectrum mode: the engine hands every sample of the first channels over in
+// blocks, the display transforms frames of SPECTRUM_SIZE samples, a quarter
+// of a frame apart
+#define SPECTRUM_BLOCK 256
+#define SPECTRUM_BLOCKS 128 // 680 ms at 48 kHz for the display to fall behind by
+#define SPECTRUM_SIZE 8192
+#define SPECTRUM_HOP (SPECTRUM_SIZE / 4)
+#define SPECTRUM_MIN 10.f // hz at the left edge, the right one is nyquist
+#define SPECTRUM_RANGE 120.f // db from the top down, 0 db is a 10 v sine
+#define SPECTRUM_AVERAGE 0.25f // time constant of the averaged spectrum, s
+#define SPECTRUM_FALL 10.f // db/s the held peaks fall by
+
+struct SpectrumBlock {
+	float x[SPECTRUM_BLOCK];
+	float y[SPECTRUM_BLOCK];
+	float sampleRate;
+};
+
+typedef SpscRing<SpectrumBlock, SPECTRUM_BLOCKS> SpectrumRing;
+
+// one published density grid, rows from the top
+struct DensityImage {
+	int32_t counts[DENSITY_SIZE * DENSITY_SIZE] = {};
+	uint32_t revision = 0;
+};
+
+// lissajous density: how often x and y passed through each cell of a grid
+// laid over the display, fading away with the persistence. every sample of
+// every channel adds a whole hit to its cell, and the grid fades by an
+// eighth a row at a time, in int32_4 lanes, spread over the samples so no
+// one sample pays for the whole grid. counts stay far below overflow, a
+// cell hit by all 16 channels on every sample of the longest persistence
+// at 192 kHz settles around 2^30
+struct ScopeDensity {
+	typedef simd::float_4 float_4;
+	typedef simd::int32_4 int32_4;
+
+	int32_t counts[DENSITY_SIZE * DENSITY_SIZE] = {};
+	TripleBuffer<DensityImage> images;
+	uint32_t revision = 0;
+
+	// voltage to cell, as the lissajous traces are drawn. the grid starts
+	// over when the knobs move, old counts would land in the wrong place
+	float scaleX = NAN, posX = NAN, scaleY = NAN, posY = NAN;
+	float kx = 0.f, cx = 0.f, ky = 0.f, cy = 0.f;
+
+	int decayRow = 0;
+	float decayDue = 0.f; // rows
+
+	void configure(float scaleX, float posX, float scaleY, float posY) {
+		if (scaleX == this->scaleX && posX == this->posX && scaleY == this->scaleY && posY == this->posY)
+			return;
+		this->scaleX = scaleX;
+		this->posX = posX;
+		this->scaleY = scaleY;
+		this->posY = posY;
+		float gainX = std::pow(2.f, std::round(scaleX));
+		float gainY = std::pow(2.f, std::round(scaleY));
+		kx = DENSITY_SIZE * gainX / 20.f;
+		cx = DENSITY_SIZE * (0.5f + posX * gainX / 20.f);
+		ky = -DENSITY_SIZE * gainY / 20.f;
+		cy = DENSITY_SIZE * (0.5f - posY * gainY / 20.f);
+		memset(counts, 0, sizeof(counts));
+	}
+
+	void process(Input &x, Input &y, int channels, float persistence, float sampleRate) {
+		for (int c = 0; c < channels; c += 4) {
+			float_4 fx = x.getPolyVoltageSimd<float_4>(c) * kx + cx;
+			float_4 fy = y.getPolyVoltageSimd<float_4>(c) * ky + cy;
+			int lanes = std::min(channels - c, 4);
+			for (int i = 0; i < lanes; i++) {
+				// off the grid, or not a number, goes nowhere
+				if (fx[i] >= 0.f && fx[i] < DENSITY_SIZE && fy[i] >= 0.f && fy[i] < DENSITY_SIZE)
+					counts[(int) fy[i] * DENSITY_SIZE + (int) fx[i]] += DENSITY_HIT;
+			}
+		}
+
+		// fading by an eighth every pass over the grid is a time constant
+		// of log(8 / 7) passes
+		decayDue += DENSITY_SIZE / (0.1335f * persistence * sampleRate);
+		while (decayDue >= 1.f) {
+			int32_t *row = &counts[decayRow * DENSITY_SIZE];
+			for (int i = 0; i < DENSITY_SIZE; i += 4) {
+				int32_4 v = int32_4::load(&row[i]);
+				densityFade(v).store(&row[i]);
+			}
+			decayRow = (decayRow + 1) % DENSITY_SIZE;
+			decayDue -= 1.f;
+		}
+	}
+
+	void publish() {
+		DensityImage &image = images.write();
+		memcpy(image.counts, counts, sizeof(counts));
+		image.revision = ++revision;
+		images.publish();
+	}
+};
 
 struct FullScope : Module {
 	enum ParamIds {
@@ -21,6 +315,8 @@ struct FullScope : Module {
 		COLOR_INPUT,
 		TIME_INPUT,
 		ROTATION_INPUT,
+		TRIG_INPUT,
+		Z_INPUT,
 		NUM_INPUTS
 	};
 	enum OutputIds {
@@ -30,15 +326,78 @@ struct FullScope : Module {
         NUM_LIGHTS
     };
 
-	float bufferX[BUFFER_SIZE] = {};
-	float bufferY[BUFFER_SIZE] = {};
-	int bufferIndex = 0;
+	// written on the engine thread, the display reads published snapshots
+	TripleBuffer<ScopeCapture> captures;
+	TripleBuffer<ScopeStats> publishedStats;
 	float frameIndex = 0;
+	int publishFrame = 0;
+	bool shown = false; // points copied into the capture since the last publish
 	float width = 26 * RACK_GRID_WIDTH;
 
+	// every point goes into the ring, whatever the trigger is doing, so a
+	// sweep can reach back before its trigger and the next one can start
+	// right where the last ended
+	float ringX[BUFFER_SIZE][PORT_MAX_CHANNELS] = {};
+	float ringY[BUFFER_SIZE][PORT_MAX_CHANNELS] = {};
+	float ringZ[BUFFER_SIZE][PORT_MAX_CHANNELS] = {};
+	int ringChannels = 1;
+	int64_t pointCount = 0; // captured so far, the newest is pointCount - 1
+	int64_t pointsShown = 0; // pointCount when points were last shown
+	uint32_t revision = 0; // of the points last shown
+
+	// a sweep runs from sweepStart for BUFFER_SIZE points, with the trigger
+	// sweepPhase after its pre-trigger points
+	bool sweeping = false;
+	int64_t sweepStart = 0;
+	float sweepPhase = 0.f;
+	int64_t sweepEnd = 0; // of the last one
+	float sinceSweep = INFINITY; // samples since the last one started, for the holdoff
+	float waiting = 0.f; // samples armed without a trigger, for free running
+	float lastTriggerValue = 0.f;
+	bool triggerPrimed = false; // went back past the level since the last trigger
+
 	bool lissajous = true;
 	bool showstats = false;
-	dsp::SchmittTrigger resetTrigger;
+	bool roll = false;
+	int statsSpan = 1; // into STATS_SPANS
+	bool statsDecay = false;
+	int statsChannel = 0;
+	ScopeStatsAccumulator stats;
+	bool density = false;
+	int persistence = 1; // into PERSISTENCE_TIMES
+	bool spectrum = false;
+	bool view3d = false;
+	int elevation = 2; // into CAMERA_ELEVATIONS
+	int perspective = 1; // into CAMERA_DISTANCES
+	bool triggerFalling = false;
+	int holdoff = 0; // into HOLDOFF_TIMES
+	int pretrigger = 0; // into PRETRIGGER_SPANS
+
+	// roll mode keeps x and y at every resolution, see minmax-pyramid.hpp
+	typedef MinMaxPyramid<2> History;
+	std::unique_ptr<History> history;
+	bool rolling = false; // engine side, the history is being filled
+
+	// allocated the first time density mode is switched on, like the history
+	std::unique_ptr<ScopeDensity> densityGrid;
+
+	// spectrum blocks on their way to the display, the same
+	std::unique_ptr<SpectrumRing> spectrumRing;
+	SpectrumBlock *spectrumBlock = nullptr; // being filled
+	int spectrumFill = 0;
+
+	// recording to disk, see recorder.hpp. the ui thread starts a recording
+	// and asks for it to stop, the engine thread pushes frames and says when
+	// it's done with the recorder
+	enum RecordStates {
+		RECORD_IDLE,
+		RECORD_RUNNING,
+		RECORD_STOPPING
+	};
+	std::atomic<int> recordState {RECORD_IDLE};
+	std::unique_ptr<SampleRecorder> recorder;
+	int recordFormat = SampleRecorder::WAV;
+	int recordX = 1, recordY = 1; // channels of each input in a frame
 
 	FullScope() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -48,19 +407,149 @@ struct FullScope : Module {
 		configParam(Y_SCALE_PARAM, -2.f, 8.f, 0.f, "y scale", " v", 1/2.f, 10);
 		configParam(ROTATION_PARAM, -10.0, 10.0, 0, "rotation");
 		configParam(TIME_PARAM, 4.f, 16.f, 10.f, "time");
+		configParam(TRIG_PARAM, -10.f, 10.f, 0.f, "trigger level", " v");
 		configInput(X_INPUT, "x");
 		configInput(Y_INPUT, "y");
 		configInput(COLOR_INPUT, "color cv");
 		configInput(TIME_INPUT, "time cv");
 		configInput(ROTATION_INPUT, "rotation cv");
+		configInput(TRIG_INPUT, "external trigger");
+		configInput(Z_INPUT, "z");
 	}
 
 	void process(const ProcessArgs &args) override;
 
+	void setDensity(bool density) {
+		if (density && !densityGrid)
+			densityGrid.reset(new ScopeDensity());
+		this->density = density;
+	}
+
+	void setSpectrum(bool spectrum) {
+		if (spectrum && !spectrumRing)
+			spectrumRing.reset(new SpectrumRing());
+		this->spectrum = spectrum;
+	}
+
+	// the history is only allocated the first time roll mode is switched on
+	void setRoll(bool roll) {
+		if (roll && !history)
+			history.reset(new History());
+		this->roll = roll;
+	}
+
+	// ui side. a frame is the x channels then the y channels, as many as
+	// were patched at the start and at least one of each
+	bool startRecording() {
+		if (recordState.load(std::memory_order_acquire) != RECORD_IDLE)
+			return false;
+		// waits for the last recording's writer to finish
+		recorder.reset();
+		recordX = std::max(inputs[X_INPUT].getChannels(), 1);
+		recordY = std::max(inputs[Y_INPUT].getChannels(), 1);
+		int channels = recordX + recordY;
+		int sampleRate = (int) APP->engine->getSampleRate();
+
+		std::string dir = asset::user("anomalies");
+		system::createDirectories(dir);
+		char stamp[32];
+		time_t now = time(NULL);
+		strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+		// numbered when there was one in the same second already
+		std::string path;
+		for (int n = 1; n == 1 || system::exists(path); n++) {
+			std::string base = (n == 1) ? string::f("fullscope-%s", stamp) : string::f("fullscope-%s-%d", stamp, n);
+			path = system::join(dir, (recordFormat == SampleRecorder::WAV) ? base + ".wav"
+				: string::f("%s-%dhz-%dch.f32", base.c_str(), sampleRate, channels));
+		}
+
+		// kept when it fails, for the menu to say so
+		recorder.reset(new SampleRecorder);
+		if (!recorder->start(path, (SampleRecorder::Format) recordFormat, channels, sampleRate))
+			return false;
+		recordState.store(RECORD_RUNNING, std::memory_order_release);
+		return true;
+	}
+
+	void stopRecording() {
+		int running = RECORD_RUNNING;
+		recordState.compare_exchange_strong(running, RECORD_STOPPING, std::memory_order_acq_rel);
+	}
+
+	// engine side, once the ui has asked
+	void endRecording() {
+		recorder->end();
+		recordState.store(RECORD_IDLE, std::memory_order_release);
+	}
+
+	// a bypassed module records nothing, but a stop asked for meanwhile
+	// still has to end the recording and let the writer close the file
+	void processBypass(const ProcessArgs &args) override {
+		if (recordState.load(std::memory_order_acquire) == RECORD_STOPPING)
+			endRecording();
+		Module::processBypass(args);
+	}
+
+	// the ring goes to the display in place, with the points to show
+	// marked, so there's no reordering and the transform walks it as before.
+	// only the points shown are copied, and of those the float_4 groups of
+	// channels in use, the rest of the capture is walked but never drawn
+	void show(int64_t first, int points, float phase) {
+		ScopeCapture &capture = captures.write();
+		// sweeps can reach back before the first point, into the zeros
+		capture.start = (int) (((first % BUFFER_SIZE) + BUFFER_SIZE) % BUFFER_SIZE);
+		size_t width = ((ringChannels + 3) / 4) * 4 * sizeof(float);
+		bool z = inputs[Z_INPUT].isConnected();
+		for (int k = 0, i = capture.start; k < points; k++, i = (i + 1) % BUFFER_SIZE) {
+			memcpy(capture.x[i], ringX[i], width);
+			memcpy(capture.y[i], ringY[i], width);
+			if (z)
+				memcpy(capture.z[i], ringZ[i], width);
+		}
+		if (!z && !capture.zeroZ)
+			memset(capture.z, 0, sizeof(capture.z));
+		capture.zeroZ = !z;
+		capture.points = points;
+		capture.phase = phase;
+		capture.channels = ringChannels;
+		capture.revision = ++revision;
+		pointsShown = pointCount;
+		shown = true;
+	}
+
+	// without new points the display keeps the ones it has, the statistics
+	// go on their own so publishing them alone copies nothing else
+	void publish() {
+		if (shown)
+			captures.publish();
+		if (showstats) {
+			ScopeStats &snapshot = publishedStats.write();
+			stats.publish(snapshot);
+			snapshot.channels = ringChannels;
+			publishedStats.publish();
+		}
+		shown = false;
+		publishFrame = 0;
+	}
+
 	json_t *dataToJson() override {
 		json_t *rootJ = json_object();
 		json_object_set_new(rootJ, "lissajous", json_integer((int) lissajous));
 		json_object_set_new(rootJ, "showstats", json_integer((int) showstats));
+		json_object_set_new(rootJ, "roll", json_boolean(roll));
+		json_object_set_new(rootJ, "density", json_boolean(density));
+		json_object_set_new(rootJ, "spectrum", json_boolean(spectrum));
+		json_object_set_new(rootJ, "view3d", json_boolean(view3d));
+		json_object_set_new(rootJ, "elevation", json_integer(elevation));
+		json_object_set_new(rootJ, "perspective", json_integer(perspective));
+		json_object_set_new(rootJ, "persistence", json_integer(persistence));
+		json_object_set_new(rootJ, "statsspan", json_integer(statsSpan));
+		json_object_set_new(rootJ, "statsdecay", json_boolean(statsDecay));
+		json_object_set_new(rootJ, "statschannel", json_integer(statsChannel));
+		json_object_set_new(rootJ, "triggerfalling", json_boolean(triggerFalling));
+		json_object_set_new(rootJ, "holdoff", json_integer(holdoff));
+		json_object_set_new(rootJ, "pretrigger", json_integer(pretrigger));
+		json_object_set_new(rootJ, "recordformat", json_integer(recordFormat));
 		json_object_set_new(rootJ, "width", json_real(width));
 		return rootJ;
 	}
@@ -74,6 +563,62 @@ struct FullScope : Module {
 		if (statJ)
 			showstats = json_integer_value(statJ);
 
+		json_t *statsSpanJ = json_object_get(rootJ, "statsspan");
+		if (statsSpanJ)
+			statsSpan = clamp((int) json_integer_value(statsSpanJ), 0, (int) LENGTHOF(STATS_SPANS) - 1);
+
+		json_t *statsDecayJ = json_object_get(rootJ, "statsdecay");
+		if (statsDecayJ)
+			statsDecay = json_boolean_value(statsDecayJ);
+
+		json_t *statsChannelJ = json_object_get(rootJ, "statschannel");
+		if (statsChannelJ)
+			statsChannel = clamp((int) json_integer_value(statsChannelJ), 0, PORT_MAX_CHANNELS - 1);
+
+		json_t *triggerFallingJ = json_object_get(rootJ, "triggerfalling");
+		if (triggerFallingJ)
+			triggerFalling = json_boolean_value(triggerFallingJ);
+
+		json_t *holdoffJ = json_object_get(rootJ, "holdoff");
+		if (holdoffJ)
+			holdoff = clamp((int) json_integer_value(holdoffJ), 0, (int) LENGTHOF(HOLDOFF_TIMES) - 1);
+
+		json_t *pretriggerJ = json_object_get(rootJ, "pretrigger");
+		if (pretriggerJ)
+			pretrigger = clamp((int) json_integer_value(pretriggerJ), 0, (int) LENGTHOF(PRETRIGGER_SPANS) - 1);
+
+		json_t *recordFormatJ = json_object_get(rootJ, "recordformat");
+		if (recordFormatJ)
+			recordFormat = clamp((int) json_integer_value(recordFormatJ), 0, (int) SampleRecorder::RAW);
+
+		json_t *persistenceJ = json_object_get(rootJ, "persistence");
+		if (persistenceJ)
+			persistence = clamp((int) json_integer_value(persistenceJ), 0, (int) LENGTHOF(PERSISTENCE_TIMES) - 1);
+
+		json_t *densityJ = json_object_get(rootJ, "density");
+		if (densityJ)
+			setDensity(json_boolean_value(densityJ));
+
+		json_t *spectrumJ = json_object_get(rootJ, "spectrum");
+		if (spectrumJ)
+			setSpectrum(json_boolean_value(spectrumJ));
+
+		json_t *view3dJ = json_object_get(rootJ, "view3d");
+		if (view3dJ)
+			view3d = json_boolean_value(view3dJ);
+
+		json_t *elevationJ = json_object_get(rootJ, "elevation");
+		if (elevationJ)
+			elevation = clamp((int) json_integer_value(elevationJ), 0, (int) LENGTHOF(CAMERA_ELEVATIONS) - 1);
+
+		json_t *perspectiveJ = json_object_get(rootJ, "perspective");
+		if (perspectiveJ)
+			perspective = clamp((int) json_integer_value(perspectiveJ), 0, (int) LENGTHOF(CAMERA_DISTANCES) - 1);
+
+		json_t *rollJ = json_object_get(rootJ, "roll");
+		if (rollJ)
+			setRoll(json_boolean_value(rollJ));
+
 		json_t *widthJ = json_object_get(rootJ, "width");
 		if (widthJ)
 			width = json_number_value(widthJ);
@@ -82,122 +627,597 @@ struct FullScope : Module {
 	void onReset() override {
 		lissajous = true;
 		showstats = false;
+		statsSpan = 1;
+		statsDecay = false;
+		statsChannel = 0;
+		triggerFalling = false;
+		holdoff = 0;
+		pretrigger = 0;
+		persistence = 1;
+		setDensity(false);
+		setSpectrum(false);
+		view3d = false;
+		elevation = 2;
+		perspective = 1;
+		setRoll(false);
 	}
 };
 
 void FullScope::process(const ProcessArgs &args) {
+	// Recordings take every sample, patched or not, so their time stays true
+	int record = recordState.load(std::memory_order_acquire);
+	if (record == RECORD_RUNNING) {
+		if (float *frame = recorder->frame()) {
+			bool x = inputs[X_INPUT].isConnected(), y = inputs[Y_INPUT].isConnected();
+			for (int c = 0; c < recordX; c++)
+				frame[c] = x ? inputs[X_INPUT].getPolyVoltage(c) : 0.f;
+			for (int c = 0; c < recordY; c++)
+				frame[recordX + c] = y ? inputs[Y_INPUT].getPolyVoltage(c) : 0.f;
+			recorder->commitFrame();
+		}
+	}
+	else if (record == RECORD_STOPPING) {
+		endRecording();
+	}
+
+	// Nothing to capture, and nothing new for the display to redraw
+	if (!inputs[X_INPUT].isConnected() && !inputs[Y_INPUT].isConnected())
+		return;
+
+	int channels = std::max(std::max(inputs[X_INPUT].getChannels(), inputs[Y_INPUT].getChannels()), inputs[Z_INPUT].getChannels());
+
+	// Statistics take in every sample, the display gets them at its own pace
+	if (showstats) {
+		stats.configure(STATS_SPANS[statsSpan], args.sampleRate, statsDecay, channels);
+		stats.process(inputs[X_INPUT], inputs[Y_INPUT]);
+	}
+
 	// Compute time
 	float deltaTime = std::pow(2.f, -params[TIME_PARAM].getValue() + inputs[TIME_INPUT].getVoltage());
 	int frameCount = (int) std::ceil(deltaTime * args.sampleRate);
 
-	// Add frame to buffer
-	if (bufferIndex < BUFFER_SIZE) {
-		if (++frameIndex > frameCount) {
-			frameIndex = 0;
-			bufferX[bufferIndex] = inputs[X_INPUT].getVoltage();
-			bufferY[bufferIndex] = inputs[Y_INPUT].getVoltage();
-			bufferIndex++;
+	// Roll mode keeps every sample, it starts over when switched on
+	if (roll) {
+		if (!rolling || history->sampleRate != args.sampleRate) {
+			history->clear(args.sampleRate);
+			rolling = true;
 		}
+		float values[2] = {inputs[X_INPUT].getVoltage(), inputs[Y_INPUT].getVoltage()};
+		history->push(values);
+	}
+	else {
+		rolling = false;
 	}
 
-	// Are we waiting on the next trigger?
-	if (bufferIndex >= BUFFER_SIZE) {
-		// Trigger immediately if external but nothing plugged in, or in Lissajous mode
-		if (lissajous) {
-			bufferIndex = 0;
-			frameIndex = 0;
-			return;
+	// Spectrum mode hands every sample of the first channels over to the
+	// display, which does the transforms. samples are dropped while it's
+	// behind
+	if (spectrum) {
+		if (!spectrumBlock) {
+			spectrumBlock = spectrumRing->writeSlot();
+			spectrumFill = 0;
 		}
-
-		// Reset the Schmitt trigger so we don't trigger immediately if the input is high
-		if (frameIndex == 0) {
-			resetTrigger.reset();
+		if (spectrumBlock) {
+			spectrumBlock->x[spectrumFill] = inputs[X_INPUT].getVoltage();
+			spectrumBlock->y[spectrumFill] = inputs[Y_INPUT].getVoltage();
+			if (++spectrumFill == SPECTRUM_BLOCK) {
+				spectrumBlock->sampleRate = args.sampleRate;
+				spectrumRing->commitWrite();
+				spectrumBlock = nullptr;
+			}
 		}
-		frameIndex++;
+	}
 
-		// Must go below 0.1V to trigger
-		// resetTrigger.setThresholds(params[TRIG_PARAM].getValue() - 0.1, params[TRIG_PARAM].getValue());
-		float gate = inputs[X_INPUT].getVoltage();
+	// Add frame to the ring
+	if (++frameIndex > frameCount) {
+		frameIndex = 0;
+		int i = (int) (pointCount % BUFFER_SIZE);
+		for (int c = 0; c < channels; c += 4) {
+			inputs[X_INPUT].getPolyVoltageSimd<simd::float_4>(c).store(&ringX[i][c]);
+			inputs[Y_INPUT].getPolyVoltageSimd<simd::float_4>(c).store(&ringY[i][c]);
+			inputs[Z_INPUT].getPolyVoltageSimd<simd::float_4>(c).store(&ringZ[i][c]);
+		}
+		ringChannels = channels;
+		pointCount++;
+	}
+	bool publishDue = ++publishFrame >= args.sampleRate / PUBLISH_RATE;
 
-		// Reset if triggered
-		float holdTime = 0.1;
-		if (resetTrigger.process(gate) || (frameIndex >= args.sampleRate * holdTime)) {
-			bufferIndex = 0; frameIndex = 0; return;
+	// Lissajous mode shows the newest points at the display's pace, the
+	// density takes in every sample
+	if (lissajous) {
+		sweeping = false;
+		if (density) {
+			densityGrid->configure(params[X_SCALE_PARAM].getValue(), params[X_POS_PARAM].getValue(), params[Y_SCALE_PARAM].getValue(), params[Y_POS_PARAM].getValue());
+			densityGrid->process(inputs[X_INPUT], inputs[Y_INPUT], channels, PERSISTENCE_TIMES[persistence], args.sampleRate);
 		}
+		if (publishDue) {
+			if (density)
+				densityGrid->publish();
+			if (pointCount != pointsShown)
+				show(std::max(pointCount - BUFFER_SIZE, (int64_t) 0), (int) std::min(pointCount, (int64_t) BUFFER_SIZE), 0.f);
+			if (shown || showstats)
+				publish();
+			publishFrame = 0;
+		}
+		return;
+	}
 
-		// Reset if we've waited too long
-		if (frameIndex >= args.sampleRate * holdTime) {
-			bufferIndex = 0; frameIndex = 0; return;
+	// Look for the trigger on every sample, on the external input when
+	// patched, otherwise on the first channel of x, or of y without x.
+	// falling edges are rising ones upside down
+	float level = params[TRIG_PARAM].getValue();
+	float value = inputs[TRIG_INPUT].isConnected() ? inputs[TRIG_INPUT].getVoltage()
+		: inputs[X_INPUT].isConnected() ? inputs[X_INPUT].getVoltage() : inputs[Y_INPUT].getVoltage();
+	if (triggerFalling) {
+		level = -level;
+		value = -value;
+	}
+	if (value <= level - TRIGGER_HYSTERESIS)
+		triggerPrimed = true;
+	bool crossed = triggerPrimed && lastTriggerValue < level && value >= level;
+	float previous = lastTriggerValue;
+	lastTriggerValue = value;
+	if (crossed)
+		triggerPrimed = false;
+
+	// A new sweep starts at a trigger once the last one is done and the
+	// holdoff is over, or free runs when none come
+	float pointSamples = frameCount + 1;
+	sinceSweep++;
+	if (!sweeping && sinceSweep >= HOLDOFF_TIMES[holdoff] * args.sampleRate) {
+		waiting++;
+		int pre = (int) (PRETRIGGER_SPANS[pretrigger] * BUFFER_SIZE);
+		if (crossed) {
+			// where between the last two samples the level was crossed,
+			// in points after the newest one
+			float fraction = (level - previous) / (value - previous);
+			float time = (frameIndex - 1.f + fraction) / pointSamples;
+			float whole = std::floor(time);
+			sweepStart = pointCount - 1 + (int64_t) whole - pre;
+			sweepPhase = time - whole;
+			sweeping = true;
+			sinceSweep = 0.f;
+		}
+		else if (waiting >= AUTO_TRIGGER_TIME * args.sampleRate) {
+			// free running sweeps follow on from each other when they're
+			// slow, fast ones are the newest points and show right away
+			sweepStart = std::max(sweepEnd, std::max(pointCount - BUFFER_SIZE, (int64_t) 0));
+			sweepPhase = 0.f;
+			sweeping = true;
+			sinceSweep = 0.f;
 		}
 	}
+
+	// Hand finished sweeps over right away. sweeps slower than the display
+	// are shown as they fill in, statistics at the display's pace
+	if (sweeping && pointCount >= sweepStart + BUFFER_SIZE) {
+		show(sweepStart, BUFFER_SIZE, sweepPhase);
+		sweeping = false;
+		sweepEnd = sweepStart + BUFFER_SIZE;
+		waiting = 0.f;
+		publish();
+	}
+	else if (publishDue) {
+		if (sweeping && pointCount != pointsShown && BUFFER_SIZE * pointSamples > args.sampleRate / PUBLISH_RATE)
+			show(sweepStart, (int) std::max(pointCount - sweepStart, (int64_t) 0), sweepPhase);
+		if (shown || showstats)
+			publish();
+	}
 }
 
-struct FullScopeDisplay : TransparentWidget {
+// capture points to pixels in one pass. offset, gain, the spin around the
+// centre and the viewport fold into one affine map, applied to four
+// channels of a point at a time. the capture ring is walked as its two
+// contiguous runs, oldest first, so no index has to wrap per point
+struct TraceTransform {
+	typedef simd::float_4 float_4;
+
+	// px = xa a + xb b + x0, py likewise, with a the x input in lissajous
+	// mode or the point's place in time in waveform mode, and b the value
+	float xa = 1.f, xb = 0.f, x0 = 0.f;
+	float ya = 0.f, yb = 1.f, y0 = 0.f;
+
+	TraceTransform(Vec size, float rot, bool lissajous, float gainA, float offsetA, float gainB, float offsetB, float phase = 0.f) {
+		// unrotated, px = ka a + kx and py = kb b + ky. a sweep moves left
+		// by its trigger's phase, so the trigger always lands on the same x
+		float ka = lissajous ? size.x * gainA / 20.f : size.x / (BUFFER_SIZE - 1);
+		float kx = lissajous ? size.x * (0.5f + offsetA * gainA / 20.f) : -ka * phase;
+		float kb = -size.y * gainB / 20.f;
+		float ky = size.y * (0.5f - offsetB * gainB / 20.f);
+		float cx = size.x / 2.f, cy = size.y / 2.f;
+		float c = std::cos(rot), s = std::sin(rot);
+		xa = ka * c;
+		xb = -kb * s;
+		x0 = cx + (kx - cx) * c - (ky - cy) * s;
+		ya = ka * s;
+		yb = kb * c;
+		y0 = cy + (kx - cx) * s + (ky - cy) * c;
+	}
+
+	// a is null in waveform mode. the pixels come out in time order, rows
+	// of channels like the capture's
+	void apply(const float (*a)[PORT_MAX_CHANNELS], const float (*b)[PORT_MAX_CHANNELS], int start, int channels,
+		float (*px)[PORT_MAX_CHANNELS], float (*py)[PORT_MAX_CHANNELS]) const {
+		int groups = (channels + 3) / 4;
+		int k = 0;
+		for (int run = 0; run < 2; run++) {
+			int from = run ? 0 : start;
+			int to = run ? start : BUFFER_SIZE;
+			for (int i = from; i < to; i++, k++) {
+				float_4 time = (float) k;
+				for (int g = 0; g < groups; g++) {
+					float_4 va = a ? float_4::load(&a[i][g * 4]) : time;
+					float_4 vb = float_4::load(&b[i][g * 4]);
+					(va * xa + vb * xb + x0).store(&px[k][g * 4]);
+					(va * ya + vb * yb + y0).store(&py[k][g * 4]);
+				}
+			}
+		}
+	}
+};
+
+// 3d points to pixels in one pass, four channels of a point at a time like
+// TraceTransform. the inputs are scaled and offset as in lissajous mode, z
+// with the x scale and no offset. the camera turns the figure by the yaw
+// around the display's vertical, then looks down on it from the elevation,
+// and perspective shrinks what's further away. with none of those it's the
+// flat lissajous figure
+struct TraceProjection {
+	typedef simd::float_4 float_4;
+
+	float gainX, offsetX, gainY, offsetY;
+	float cosYaw, sinYaw, cosElevation, sinElevation;
+	float distance; // infinite without perspective
+	float kx, ky, cx, cy; // scaled volts to pixels
+
+	TraceProjection(Vec size, float yaw, float elevation, float distance, float gainX, float offsetX, float gainY, float offsetY)
+		: gainX(gainX), offsetX(offsetX), gainY(gainY), offsetY(offsetY), distance(distance) {
+		cosYaw = std::cos(yaw);
+		sinYaw = std::sin(yaw);
+		cosElevation = std::cos(elevation);
+		sinElevation = std::sin(elevation);
+		kx = size.x / 20.f;
+		ky = -size.y / 20.f;
+		cx = size.x / 2.f;
+		cy = size.y / 2.f;
+	}
+
+	void apply(const float (*x)[PORT_MAX_CHANNELS], const float (*y)[PORT_MAX_CHANNELS], const float (*z)[PORT_MAX_CHANNELS],
+		int start, int channels, float (*px)[PORT_MAX_CHANNELS], float (*py)[PORT_MAX_CHANNELS]) const {
+		int groups = (channels + 3) / 4;
+		bool perspective = std::isfinite(distance);
+		int k = 0;
+		for (int run = 0; run < 2; run++) {
+			int from = run ? 0 : start;
+			int to = run ? start : BUFFER_SIZE;
+			for (int i = from; i < to; i++, k++) {
+				for (int g = 0; g < groups; g++) {
+					float_4 vx = (float_4::load(&x[i][g * 4]) + offsetX) * gainX;
+					float_4 vy = (float_4::load(&y[i][g * 4]) + offsetY) * gainY;
+					float_4 vz = float_4::load(&z[i][g * 4]) * gainX;
+					// yaw, then elevation, z towards the viewer
+					float_4 rx = vx * cosYaw + vz * sinYaw;
+					float_4 rz = vz * cosYaw - vx * sinYaw;
+					float_4 ry = vy * cosElevation - rz * sinElevation;
+					if (perspective) {
+						// nothing comes closer than a tenth of the distance
+						float_4 depth = vy * sinElevation + rz * cosElevation;
+						float_4 scale = distance / simd::fmax(distance - depth, 0.1f * distance);
+						rx *= scale;
+						ry *= scale;
+					}
+					(rx * kx + cx).store(&px[k][g * 4]);
+					(ry * ky + cy).store(&py[k][g * 4]);
+				}
+			}
+		}
+	}
+};
+
+// builds a trace path from points in pixels with no more vertices than the
+// display can show. a waveform's points are merged per pixel column into
+// their lowest and highest, in the order they came, or into one vertex when
+// they're within a pixel, so there are at most two vertices per column.
+// lissajous figures go anywhere, there a point is only dropped when it
+// lands on the same pixel as the last vertex
+struct TracePath {
+	NVGcontext *vg;
+	bool columns;
+	int vertices = 0;
+	int column = INT_MIN;
+	int points = 0; // in the current column
+	float firstX = 0.f, firstY = 0.f, lo = 0.f, hi = 0.f;
+	bool loFirst = true;
+	float lastX = 0.f, lastY = 0.f;
+
+	TracePath(NVGcontext *vg, bool columns) : vg(vg), columns(columns) {
+		nvgBeginPath(vg);
+	}
+
+	void vertex(float x, float y) {
+		if (vertices++ == 0)
+			nvgMoveTo(vg, x, y);
+		else
+			nvgLineTo(vg, x, y);
+		lastX = x;
+		lastY = y;
+	}
+
+	void flushColumn() {
+		if (points == 1) {
+			vertex(firstX, firstY);
+		}
+		else if (points > 1 && hi - lo < 1.f) {
+			vertex(column + 0.5f, 0.5f * (lo + hi));
+		}
+		else if (points > 1) {
+			float x = column + 0.5f;
+			vertex(x, loFirst ? lo : hi);
+			vertex(x, loFirst ? hi : lo);
+		}
+		points = 0;
+	}
+
+	void add(float x, float y) {
+		if (!columns) {
+			if (vertices == 0 || (int) x != (int) lastX || (int) y != (int) lastY)
+				vertex(x, y);
+			return;
+		}
+		int c = (int) std::floor(x);
+		if (c != column) {
+			flushColumn();
+			column = c;
+		}
+		if (points++ == 0) {
+			firstX = x;
+			firstY = y;
+			lo = hi = y;
+			loFirst = true;
+			return;
+		}
+		if (y < lo) {
+			lo = y;
+			loFirst = false;
+		}
+		if (y > hi) {
+			hi = y;
+			loFirst = true;
+		}
+	}
+
+	void finish() {
+		if (columns)
+			flushColumn();
+	}
+};
+
+// spectra of x and y, worked out on the ui thread from the blocks the engine
+// hands over. each hann windowed frame's power goes into an exponential
+// average and into peaks that are held and slowly fall
+struct ScopeSpectrum {
+	static constexpr int BINS = SPECTRUM_SIZE / 2;
+
+	dsp::RealFFT fft;
+	float window[SPECTRUM_SIZE];
+	alignas(16) float samples[2][SPECTRUM_SIZE] = {}; // the newest frame's worth, filling up
+	alignas(16) float frame[SPECTRUM_SIZE];
+	alignas(16) float bins[SPECTRUM_SIZE];
+	float power[2][BINS] = {};
+	float peak[2][BINS] = {};
+	int filled = 0;
+	float sampleRate = 0.f;
+
+	ScopeSpectrum() : fft(SPECTRUM_SIZE) {
+		for (int i = 0; i < SPECTRUM_SIZE; i++)
+			window[i] = 0.5f - 0.5f * std::cos(2.f * M_PI * i / SPECTRUM_SIZE);
+	}
+
+	// takes in all the blocks there are, true if a frame was transformed
+	bool update(SpectrumRing &ring) {
+		bool transformed = false;
+		while (const SpectrumBlock *block = ring.readSlot()) {
+			if (block->sampleRate != sampleRate) {
+				sampleRate = block->sampleRate;
+				filled = 0;
+				memset(power, 0, sizeof(power));
+				memset(peak, 0, sizeof(peak));
+			}
+			memcpy(&samples[0][filled], block->x, sizeof(block->x));
+			memcpy(&samples[1][filled], block->y, sizeof(block->y));
+			ring.commitRead();
+			filled += SPECTRUM_BLOCK;
+			if (filled < SPECTRUM_SIZE)
+				continue;
+			for (int input = 0; input < 2; input++) {
+				transform(input);
+				memmove(samples[input], samples[input] + SPECTRUM_HOP, (SPECTRUM_SIZE - SPECTRUM_HOP) * sizeof(float));
+			}
+			filled -= SPECTRUM_HOP;
+			transformed = true;
+		}
+		return transformed;
+	}
+
+	void transform(int input) {
+		for (int i = 0; i < SPECTRUM_SIZE; i++)
+			frame[i] = samples[input][i] * window[i];
+		fft.rfft(frame, bins);
+
+		// a sine's peak bin is a quarter of the frame times its amplitude
+		// through the window, so 10 v comes out as 1
+		float hop = SPECTRUM_HOP / sampleRate;
+		float average = 1.f - std::exp(-hop / SPECTRUM_AVERAGE);
+		float fall = std::pow(10.f, -SPECTRUM_FALL * hop / 10.f);
+		float scale = 4.f / SPECTRUM_SIZE / 10.f;
+		scale *= scale;
+		for (int k = 1; k < BINS; k++) {
+			float re = bins[2 * k], im = bins[2 * k + 1];
+			float p = (re * re + im * im) * scale;
+			power[input][k] += (p - power[input][k]) * average;
+			peak[input][k] = std::max(p, peak[input][k] * fall);
+		}
+	}
+};
+
+struct FullScopeDisplay;
+
+// draws the traces into the display's framebuffer
+struct FullScopeTraces : Widget {
+	FullScopeDisplay *display;
+	void draw(const DrawArgs &args) override;
+};
+
+// the traces are drawn into a framebuffer that is only redrawn when a new
+// capture comes in or something about the view changes. the rest of the time
+// the scope costs one textured rectangle per frame
+struct FullScopeDisplay : FramebufferWidget {
 	FullScope *module;
-	int frame = 0;
+	FullScopeTraces *traces;
 	float rot = 0;
-	std::shared_ptr<Font> font;
-
-	struct Stats {
-		float vmin, vmax;
-		void calculate(float *values) {
-			// vrms = 0.0;
-			vmax = -INFINITY;
-			vmin = INFINITY;
-			for (int i = 0; i < BUFFER_SIZE; i++) {
-				float v = values[i];
-				// vrms += v*v;
-				vmax = fmaxf(vmax, v);
-				vmin = fminf(vmin, v);
-			}
-			// vrms = sqrtf(vrms / BUFFER_SIZE);
-			// vpp = vmax - vmin;
+	float rollZoom = 0.f; // octaves in from the time knob's span
+	int64_t rollEnd = -1; // sample at the right edge, or following the input
+
+	// everything the traces depend on besides the capture, to tell when
+	// the framebuffer has to be redrawn
+	struct View {
+		float gainX = 0.f, gainY = 0.f;
+		float offsetX = 0.f, offsetY = 0.f;
+		float hue = -1.f; // -1 without a color cv
+		float rot = 0.f;
+		Vec size;
+		bool roll = false, lissajous = false, density = false, spectrum = false, view3d = false;
+		float elevation = 0.f, distance = INFINITY;
+		bool connectedX = false, connectedY = false;
+		float rollSpan = 0.f;
+		int64_t rollColumn = 0; // of the right edge, so a rolling view moves a pixel at a time
+
+		bool operator==(const View &v) const {
+			return gainX == v.gainX && gainY == v.gainY
+				&& offsetX == v.offsetX && offsetY == v.offsetY
+				&& hue == v.hue && rot == v.rot && size.x == v.size.x && size.y == v.size.y
+				&& roll == v.roll && lissajous == v.lissajous && density == v.density && spectrum == v.spectrum
+				&& view3d == v.view3d && elevation == v.elevation && distance == v.distance
+				&& connectedX == v.connectedX && connectedY == v.connectedY
+				&& rollSpan == v.rollSpan && rollColumn == v.rollColumn;
+		}
+
+		bool operator!=(const View &v) const {
+			return !(*this == v);
 		}
 	};
-	Stats statsX, statsY;
+	View view;
+	uint32_t revision = 0; // of the capture the traces were drawn from
 
-	FullScopeDisplay() {}
+	// traces in pixels, the second pair for x in waveform mode
+	float pointsX[BUFFER_SIZE][PORT_MAX_CHANNELS];
+	float pointsY[BUFFER_SIZE][PORT_MAX_CHANNELS];
+	float pointsX2[BUFFER_SIZE][PORT_MAX_CHANNELS];
+	float pointsY2[BUFFER_SIZE][PORT_MAX_CHANNELS];
+
+	// made the first time spectrum mode is shown
+	std::unique_ptr<ScopeSpectrum> spectrum;
+
+	// the density grid as an image, made in the framebuffer's context
+	uint32_t densityRevision = 0;
+	NVGcontext *densityVg = NULL;
+	int densityImage = -1;
+	uint8_t densityPixels[DENSITY_SIZE * DENSITY_SIZE * 4];
+
+	FullScopeDisplay() {
+		traces = new FullScopeTraces;
+		traces->display = this;
+		addChild(traces);
+	}
+
+	~FullScopeDisplay() {
+		if (densityImage >= 0)
+			nvgDeleteImage(densityVg, densityImage);
+	}
 
 	inline float rescalefjw(float x, float xMin, float xMax, float yMin, float yMax) {
 		return yMin + (x - xMin) / (xMax - xMin) * (yMax - yMin);
 	}
 
-	void drawWaveform(const DrawArgs &args, float *valuesX, float *valuesY) {
-		if (!valuesX)
-			return;
-		nvgSave(args.vg);
-		Rect b = Rect(Vec(0, 0), box.size);
-		nvgScissor(args.vg, b.pos.x, b.pos.y, b.size.x, b.size.y);
-
-		float rotRate = rescalefjw(module->params[FullScope::ROTATION_PARAM].getValue() + module->inputs[FullScope::ROTATION_INPUT].getVoltage(), 0, 10, 0, 0.5);
-		if(rotRate != 0){
-			nvgTranslate(args.vg, box.size.x/2.0, box.size.y/2.0);
-			nvgRotate(args.vg, rot+=rotRate);
-			nvgTranslate(args.vg, -box.size.x/2.0, -box.size.y/2.0);
-		} else {
-			nvgRotate(args.vg, 0);
+	View currentView() {
+		View v;
+		v.gainX = powf(2.0, roundf(module->params[FullScope::X_SCALE_PARAM].getValue()));
+		v.gainY = powf(2.0, roundf(module->params[FullScope::Y_SCALE_PARAM].getValue()));
+		v.offsetX = module->params[FullScope::X_POS_PARAM].getValue();
+		v.offsetY = module->params[FullScope::Y_POS_PARAM].getValue();
+		if (module->inputs[FullScope::COLOR_INPUT].isConnected())
+			v.hue = rescalefjw(module->inputs[FullScope::COLOR_INPUT].getVoltage(), 0.0, 6.0, 0, 1.0);
+		v.rot = rot;
+		v.size = box.size;
+		v.roll = module->roll && module->history;
+		v.lissajous = module->lissajous;
+		v.density = module->lissajous && module->density && module->densityGrid;
+		v.spectrum = module->spectrum && module->spectrumRing;
+		v.view3d = module->lissajous && module->view3d;
+		if (v.view3d) {
+			v.elevation = CAMERA_ELEVATIONS[module->elevation] * (M_PI / 180.f);
+			v.distance = CAMERA_DISTANCES[module->perspective];
+		}
+		v.connectedX = module->inputs[FullScope::X_INPUT].isConnected();
+		v.connectedY = module->inputs[FullScope::Y_INPUT].isConnected();
+		if (v.roll && module->history->sampleRate > 0.f) {
+			v.rollSpan = rollSpan();
+			int64_t end = module->history->end();
+			if (rollEnd >= 0 && rollEnd < end)
+				end = rollEnd;
+			v.rollColumn = (int64_t) (end / (v.rollSpan / box.size.x));
 		}
+		return v;
+	}
 
-		nvgBeginPath(args.vg);
-		// Draw maximum display left to right
-		for (int i = 0; i < BUFFER_SIZE; i++) {
-			float x, y;
-			if (valuesY) {
-				x = valuesX[i] / 2.f + 0.5f;
-				y = valuesY[i] / 2.f + 0.5f;
+	void step() override {
+		if (module) {
+			traces->box.size = box.size;
+
+			float rotRate = rescalefjw(module->params[FullScope::ROTATION_PARAM].getValue() + module->inputs[FullScope::ROTATION_INPUT].getVoltage(), 0, 10, 0, 0.5);
+			if (rotRate != 0)
+				rot += rotRate;
+			else
+				rot = 0;
+
+			// the newest whole capture, it stays put until the next one. the
+			// traces are only redrawn for new points, not for new statistics
+			module->captures.update();
+			const ScopeCapture &capture = module->captures.read();
+			View v = currentView();
+			bool densityChanged = false;
+			if (v.density) {
+				module->densityGrid->images.update();
+				densityChanged = module->densityGrid->images.read().revision != densityRevision;
+				densityRevision = module->densityGrid->images.read().revision;
 			}
-			else {
-				x = (float)i / (BUFFER_SIZE - 1);
-				y = valuesX[i] / 2.f + 0.5f;
+			bool spectrumChanged = false;
+			if (v.spectrum) {
+				if (!spectrum)
+					spectrum.reset(new ScopeSpectrum());
+				spectrumChanged = spectrum->update(*module->spectrumRing);
+			}
+			// the spectrum doesn't show the captured points
+			bool pointsChanged = capture.revision != revision && !v.spectrum;
+			if (pointsChanged || v != view || densityChanged || spectrumChanged) {
+				revision = capture.revision;
+				view = v;
+				setDirty();
 			}
-			Vec p;
-			p.x = b.pos.x + b.size.x * x;
-			p.y = b.pos.y + b.size.y * (1.0 - y);
-			if (i == 0)
-				nvgMoveTo(args.vg, p.x, p.y);
-			else
-				nvgLineTo(args.vg, p.x, p.y);
 		}
+		FramebufferWidget::step();
+	}
+
+	// one channel of transformed points. a waveform that isn't spinning
+	// runs left to right, so its path can be merged per pixel column
+	void drawWaveform(const DrawArgs &args, const float (*px)[PORT_MAX_CHANNELS], const float (*py)[PORT_MAX_CHANNELS], int points, int channel, bool columns) {
+		nvgSave(args.vg);
+		nvgScissor(args.vg, 0, 0, box.size.x, box.size.y);
+
+		TracePath path(args.vg, columns);
+		for (int i = 0; i < points; i++)
+			path.add(px[i][channel], py[i][channel]);
+		path.finish();
 		nvgLineCap(args.vg, NVG_ROUND);
 		nvgMiterLimit(args.vg, 2.f);
 		nvgStrokeWidth(args.vg, 1.5f);
@@ -207,96 +1227,317 @@ struct FullScopeDisplay : TransparentWidget {
 		nvgRestore(args.vg);
 	}
 
-	void drawStats(const DrawArgs &args, Vec pos, const char *title, Stats *stats) {
-		font = APP->window->loadFont(asset::plugin(pluginInstance, "res/font/OfficeCodePro-Light.ttf"));
-		if (!font) return;
+	// roll mode: samples across the display, from the time knob and the zoom
+	float rollSpan() {
+		float deltaTime = std::pow(2.f, -module->params[FullScope::TIME_PARAM].getValue() + module->inputs[FullScope::TIME_INPUT].getVoltage());
+		return BUFFER_SIZE * deltaTime * std::pow(2.f, -rollZoom) * module->history->sampleRate;
+	}
+
+	// scrolling zooms in and out at the right edge, shift-scrolling pans
+	// back in time and holds the view still until panned forward again
+	void scrollRoll(float delta, bool pan) {
+		if (pan) {
+			int64_t now = module->history->end();
+			int64_t end = (rollEnd >= 0 ? rollEnd : now) + (int64_t) (delta / 500.f * rollSpan());
+			rollEnd = (end >= now) ? -1 : std::max(end, (int64_t) 0);
+		}
+		else {
+			rollZoom = clamp(rollZoom + delta / 200.f, -16.f, 8.f);
+		}
+	}
+
+	// one min/max pair per pixel column, from the level of the history
+	// that has about one bucket per column at this zoom. the right edge
+	// steps a whole column at a time, so the columns don't shimmer
+	void drawRoll(const DrawArgs &args, int channel, float gain, float offset) {
+		const FullScope::History &history = *module->history;
+		if (view.rollSpan <= 0.f)
+			return;
+		int columns = (int) box.size.x;
+		float samplesPerColumn = view.rollSpan / box.size.x;
+		int level = history.level(samplesPerColumn, view.rollSpan);
+		int64_t end = (int64_t) (view.rollColumn * samplesPerColumn);
+
+		nvgSave(args.vg);
+		nvgScissor(args.vg, 0, 0, box.size.x, box.size.y);
+		nvgBeginPath(args.vg);
+		for (int i = 0; i < columns; i++) {
+			MinMaxBucket bucket;
+			int64_t start = end - (int64_t) ((columns - i) * samplesPerColumn);
+			int64_t stop = end - (int64_t) ((columns - i - 1) * samplesPerColumn);
+			if (!history.range(level, start, stop, channel, bucket))
+				continue;
+			float top = ((bucket.max + offset) * gain / 10.f) / 2.f + 0.5f;
+			float bottom = ((bucket.min + offset) * gain / 10.f) / 2.f + 0.5f;
+			// at least a pixel tall, so flat stretches still show
+			nvgMoveTo(args.vg, i + 0.5f, box.size.y * (1.f - top) - 0.5f);
+			nvgLineTo(args.vg, i + 0.5f, box.size.y * (1.f - bottom) + 0.5f);
+		}
+		nvgStrokeWidth(args.vg, 1.f);
+		nvgGlobalCompositeOperation(args.vg, NVG_LIGHTER);
+		nvgStroke(args.vg);
+		nvgResetScissor(args.vg);
+		nvgRestore(args.vg);
+	}
+
+	void drawStats(const DrawArgs &args, int fontHandle, Vec pos, const std::string &title, const ScopeStats &stats, int input, int channel) {
 		nvgFontSize(args.vg, 12);
-		nvgFontFaceId(args.vg, font->handle);
+		nvgFontFaceId(args.vg, fontHandle);
 		nvgTextLetterSpacing(args.vg, -0.5);
 
 		nvgFillColor(args.vg, nvgRGBA(0xf4, 0xbd, 0x8d, 0xc0));
-		nvgText(args.vg, pos.x, pos.y + 11, title, NULL);
+		nvgText(args.vg, pos.x, pos.y + 11, title.c_str(), NULL);
 
 		nvgFillColor(args.vg, nvgRGBA(0xf4, 0xbd, 0x8d, 0xc0));
 		pos = pos.plus(Vec(20, 11));
 
-		std::string text;
-		text = "max";
-		text += isNear(stats->vmax, 0.f, 100.f) ? string::f("% 6.2f", stats->vmax) : "  ---";
-		nvgText(args.vg, pos.x, pos.y, text.c_str(), NULL);
-		text = "min";
-		text += isNear(stats->vmin, 0.f, 100.f) ? string::f("% 6.2f", stats->vmin) : "  ---";
-		nvgText(args.vg, pos.x + 55, pos.y, text.c_str(), NULL);
+		float vmax = stats.max[input][channel];
+		float vmin = stats.min[input][channel];
+		float values[5] = {vmax, vmin, vmax - vmin, stats.rms[input][channel], stats.mean[input][channel]};
+		const char *labels[5] = {"max", "min", "vpp", "rms", " dc"};
+		for (int i = 0; i < 5; i++) {
+			std::string text = labels[i];
+			text += isNear(values[i], 0.f, 100.f) ? string::f("% 6.2f", values[i]) : "  ---";
+			nvgText(args.vg, pos.x + 55 * (i % 2), pos.y + 11 * (i / 2), text.c_str(), NULL);
+		}
 	}
 
-	void drawLayer(const DrawArgs &args, int layer) override {
-		if(!module || layer != 1) return;
+	// counts in eighths of an octave, so the image shows a wide range of
+	// densities without a logarithm per cell
+	static int densityLevel(int32_t count) {
+		int octave = 31 - __builtin_clz(count);
+		int eighth = (octave >= 3) ? (count >> (octave - 3)) & 7 : (count << (3 - octave)) & 7;
+		return octave * 8 + eighth;
+	}
+
+	// the densest cell is full brightness and 16 octaves below it fade to
+	// black, in the trace's color, going towards white where it's densest.
+	// the grid goes up as one texture, spun like the traces
+	void drawDensity(const DrawArgs &args) {
+		static const int RANGE = 16 * 8;
+		const DensityImage &image = module->densityGrid->images.read();
+		int32_t top = 0;
+		for (int i = 0; i < DENSITY_SIZE * DENSITY_SIZE; i++)
+			top = std::max(top, image.counts[i]);
+		if (top == 0)
+			return;
+
+		NVGcolor color = traceColor(0, 1, false);
+		uint32_t palette[256];
+		int bottom = densityLevel(top) - RANGE;
+		for (int l = 0; l < 256; l++) {
+			float t = clamp((float) (l - bottom) / RANGE, 0.f, 1.f);
+			float white = 0.6f * t * t * t * t;
+			uint8_t rgba[4] = {
+				(uint8_t) (255.f * clamp(color.r * t + (1.f - color.r) * white, 0.f, 1.f)),
+				(uint8_t) (255.f * clamp(color.g * t + (1.f - color.g) * white, 0.f, 1.f)),
+				(uint8_t) (255.f * clamp(color.b * t + (1.f - color.b) * white, 0.f, 1.f)),
+				(uint8_t) (255.f * std::min(1.5f * t, 1.f)),
+			};
+			memcpy(&palette[l], rgba, 4);
+		}
+		uint32_t *pixels = (uint32_t*) densityPixels;
+		for (int i = 0; i < DENSITY_SIZE * DENSITY_SIZE; i++) {
+			int32_t count = image.counts[i];
+			pixels[i] = (count > 0) ? palette[densityLevel(count)] : 0;
+		}
+
+		if (densityVg != args.vg || densityImage < 0) {
+			densityVg = args.vg;
+			densityImage = nvgCreateImageRGBA(args.vg, DENSITY_SIZE, DENSITY_SIZE, 0, densityPixels);
+		}
+		else {
+			nvgUpdateImage(args.vg, densityImage, densityPixels);
+		}
+
+		nvgSave(args.vg);
+		nvgScissor(args.vg, 0, 0, box.size.x, box.size.y);
+		nvgTranslate(args.vg, box.size.x / 2.f, box.size.y / 2.f);
+		nvgRotate(args.vg, view.rot);
+		nvgTranslate(args.vg, -box.size.x / 2.f, -box.size.y / 2.f);
+		nvgBeginPath(args.vg);
+		nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
+		nvgFillPaint(args.vg, nvgImagePattern(args.vg, 0, 0, box.size.x, box.size.y, 0.f, densityImage, 1.f));
+		nvgGlobalCompositeOperation(args.vg, NVG_LIGHTER);
+		nvgFill(args.vg);
+		nvgRestore(args.vg);
+	}
+
+	// power from the top of the display down, frequency across on a log
+	// scale, so every octave is as wide. the bins that land in one pixel
+	// column are merged like a waveform's points. the held peaks go under
+	// the average, dimmer
+	void drawSpectrum(const DrawArgs &args) {
+		if (spectrum->sampleRate <= 0.f)
+			return;
+		float octaves = std::log2(spectrum->sampleRate / 2.f / SPECTRUM_MIN);
+
+		// a faint line at every decade
+		nvgBeginPath(args.vg);
+		for (float f = 10.f * SPECTRUM_MIN; f < spectrum->sampleRate / 2.f; f *= 10.f) {
+			float x = std::log2(f / SPECTRUM_MIN) / octaves * box.size.x;
+			nvgMoveTo(args.vg, x, 0);
+			nvgLineTo(args.vg, x, box.size.y);
+		}
+		nvgStrokeColor(args.vg, nvgRGBA(0xf4, 0xbd, 0x8d, 0x30));
+		nvgStrokeWidth(args.vg, 1.f);
+		nvgStroke(args.vg);
+
+		for (int input = 1; input >= 0; input--) {
+			if (!(input ? view.connectedY : view.connectedX))
+				continue;
+			for (int held = 1; held >= 0; held--) {
+				const float *power = held ? spectrum->peak[input] : spectrum->power[input];
+				TracePath path(args.vg, true);
+				for (int k = 1; k < ScopeSpectrum::BINS; k++) {
+					float f = k * spectrum->sampleRate / SPECTRUM_SIZE;
+					if (f < SPECTRUM_MIN)
+						continue;
+					float x = std::log2(f / SPECTRUM_MIN) / octaves * box.size.x;
+					float db = 10.f * std::log10(power[k] + 1e-20f);
+					path.add(x, -db / SPECTRUM_RANGE * box.size.y);
+				}
+				path.finish();
+				NVGcolor color = traceColor(0, 1, input == 0);
+				if (held)
+					color.a *= 0.4f;
+				nvgStrokeColor(args.vg, color);
+				nvgStrokeWidth(args.vg, 1.5f);
+				nvgGlobalCompositeOperation(args.vg, NVG_LIGHTER);
+				nvgStroke(args.vg);
+			}
+		}
+	}
+
+	// mono traces keep their colors. poly channels get a hue each, spread
+	// around the wheel from the mono trace's hue
+	NVGcolor traceColor(int channel, int channels, bool x) {
+		if (channels == 1) {
+			if (x)
+				return nvgRGBA(0xb0, 0x8d, 0xf4, 0xc0); // bright lavender
+			if (view.hue >= 0.f)
+				return nvgHSLA(view.hue, 0.5, 0.5, 0xc0);
+			return nvgRGBA(0xf4, 0xbd, 0x8d, 0xc0); // mac 'n' cheese
+			//return nvgRGBA(0x9b, 0xcc, 0x82, 0xc0); // pistachio
+		}
+		float hue = x ? 0.72f : (view.hue >= 0.f ? view.hue : 0.08f);
+		hue += (float) channel / channels;
+		hue -= std::floor(hue);
+		if (view.hue >= 0.f)
+			return nvgHSLA(hue, 0.5, 0.5, 0xc0);
+		return nvgHSLA(hue, 0.8, x ? 0.8 : 0.7, 0xc0);
+	}
+
+	// called while the framebuffer is redrawn
+	void drawTraces(const DrawArgs &args) {
+		const ScopeCapture &capture = module->captures.read();
+
+		// spectrum and roll mode only keep the first channel
+		if (view.spectrum) {
+			nvgSave(args.vg);
+			nvgScissor(args.vg, 0, 0, box.size.x, box.size.y);
+			drawSpectrum(args);
+			nvgResetScissor(args.vg);
+			nvgRestore(args.vg);
+			return;
+		}
+		if (view.roll) {
+			if (view.connectedY) {
+				nvgStrokeColor(args.vg, traceColor(0, 1, false));
+				drawRoll(args, 1, view.gainY, view.offsetY);
+			}
+			if (view.connectedX) {
+				nvgStrokeColor(args.vg, traceColor(0, 1, true));
+				drawRoll(args, 0, view.gainX, view.offsetX);
+			}
+			return;
+		}
 
-		float gainX = powf(2.0, roundf(module->params[FullScope::X_SCALE_PARAM].getValue()));
-		float gainY = powf(2.0, roundf(module->params[FullScope::Y_SCALE_PARAM].getValue()));
-		float offsetX = module->params[FullScope::X_POS_PARAM].getValue();
-		float offsetY = module->params[FullScope::Y_POS_PARAM].getValue();
-
-		float valuesX[BUFFER_SIZE];
-		float valuesY[BUFFER_SIZE];
-		for (int i = 0; i < BUFFER_SIZE; i++) {
-			int j = i;
-			// Lock display to buffer if buffer update deltaTime <= 2^-11
-			if (module->lissajous)
-				j = (i + module->bufferIndex) % BUFFER_SIZE;
-			valuesX[i] = (module->bufferX[j] + offsetX) * gainX / 10.0;
-			valuesY[i] = (module->bufferY[j] + offsetY) * gainY / 10.0;
-		}
-
-		// color
-		if(module->inputs[FullScope::COLOR_INPUT].isConnected()){
-			float hue = rescalefjw(module->inputs[FullScope::COLOR_INPUT].getVoltage(), 0.0, 6.0, 0, 1.0);
-			nvgStrokeColor(args.vg, nvgHSLA(hue, 0.5, 0.5, 0xc0));
-		} else {
-			nvgStrokeColor(args.vg, nvgRGBA(0xf4, 0xbd, 0x8d, 0xc0)); // mac 'n' cheese
-			//nvgStrokeColor(args.vg, nvgRGBA(0x9b, 0xcc, 0x82, 0xc0)); // pistachio
-		}
-
-		// draw waveforms
-		if (module->lissajous) {
+		// all channels to pixels first, then one path per channel
+		if (view.lissajous) {
 			// X x Y
-			if (module->inputs[FullScope::X_INPUT].isConnected() || module->inputs[FullScope::Y_INPUT].isConnected()) {
-				drawWaveform(args, valuesX, valuesY);
+			if (!view.connectedX && !view.connectedY)
+				return;
+			if (view.view3d) {
+				// the spin turns the camera around the figure
+				TraceProjection projection(box.size, view.rot, view.elevation, view.distance, view.gainX, view.offsetX, view.gainY, view.offsetY);
+				projection.apply(capture.x, capture.y, capture.z, capture.start, capture.channels, pointsX, pointsY);
+			}
+			else if (view.density) {
+				drawDensity(args);
+				return;
+			}
+			else {
+				TraceTransform transform(box.size, view.rot, true, view.gainX, view.offsetX, view.gainY, view.offsetY);
+				transform.apply(capture.x, capture.y, capture.start, capture.channels, pointsX, pointsY);
+			}
+			for (int c = 0; c < capture.channels; c++) {
+				nvgStrokeColor(args.vg, traceColor(c, capture.channels, false));
+				drawWaveform(args, pointsX, pointsY, capture.points, c, false);
 			}
+			return;
 		}
-		else {
+
+		bool columns = view.rot == 0.f;
+		if (view.connectedY) {
+			TraceTransform transform(box.size, view.rot, false, 1.f, 0.f, view.gainY, view.offsetY, capture.phase);
+			transform.apply(NULL, capture.y, capture.start, capture.channels, pointsX, pointsY);
+		}
+		if (view.connectedX) {
+			TraceTransform transform(box.size, view.rot, false, 1.f, 0.f, view.gainX, view.offsetX, capture.phase);
+			transform.apply(NULL, capture.x, capture.start, capture.channels, pointsX2, pointsY2);
+		}
+		for (int c = 0; c < capture.channels; c++) {
 			// Y
-			if (module->inputs[FullScope::Y_INPUT].isConnected()) {
-				drawWaveform(args, valuesY, NULL);
+			if (view.connectedY) {
+				nvgStrokeColor(args.vg, traceColor(c, capture.channels, false));
+				drawWaveform(args, pointsX, pointsY, capture.points, c, columns);
 			}
 
 			// X
-			if (module->inputs[FullScope::X_INPUT].isConnected()) {
-				nvgStrokeColor(args.vg, nvgRGBA(0xb0, 0x8d, 0xf4, 0xc0)); // bright lavender
-				drawWaveform(args, valuesX, NULL);
+			if (view.connectedX) {
+				nvgStrokeColor(args.vg, traceColor(c, capture.channels, true));
+				drawWaveform(args, pointsX2, pointsY2, capture.points, c, columns);
 			}
 		}
+	}
 
-		// if stats enabled, calculate and show them
-		if (module->showstats) {
-			if (++frame >= 4) {
-				frame = 0;
-				statsX.calculate(module->bufferX);
-				statsY.calculate(module->bufferY);
-			}
+	// nothing in the room-lit layer, the scope glows in the dark
+	void draw(const DrawArgs &args) override {}
 
-			drawStats(args, Vec(18, 0), "  x", &statsX);
-			drawStats(args, Vec(144, 0), "| y", &statsY);
+	void drawLayer(const DrawArgs &args, int layer) override {
+		if(!module || layer != 1) return;
+
+		FramebufferWidget::draw(args);
+
+		// if stats enabled, show them
+		if (module->showstats) {
+			// fonts mustn't be kept across frames, loading is a cached lookup
+			std::shared_ptr<Font> font = APP->window->loadFont(asset::plugin(pluginInstance, "res/font/OfficeCodePro-Light.ttf"));
+			if (!font)
+				return;
+			// one channel's worth, the one picked in the menu
+			module->publishedStats.update();
+			const ScopeStats &stats = module->publishedStats.read();
+			int channel = std::min(module->statsChannel, stats.channels - 1);
+			bool poly = stats.channels > 1;
+			drawStats(args, font->handle, Vec(18, 0), poly ? string::f(" x%d", channel + 1) : "  x", stats, 0, channel);
+			drawStats(args, font->handle, Vec(144, 0), poly ? string::f("|y%d", channel + 1) : "| y", stats, 1, channel);
 		}
 	}
 };
 
+void FullScopeTraces::draw(const DrawArgs &args) {
+	display->drawTraces(args);
+}
+
 struct FullScopeWidget : ModuleWidget {
     BlankPanel *panel;
     Widget *rightHandle;
-	TransparentWidget *display;
+	FullScopeDisplay *display;
 	FullScopeWidget(FullScope *module);
 	void step() override;
+	void onHoverScroll(const event::HoverScroll &e) override;
 	void appendContextMenu(Menu *menu) override;
 };
 
@@ -334,6 +1575,9 @@ FullScopeWidget::FullScopeWidget(FullScope *module) {
 	addParam(createParam<KnobMiniSnap>(Vec(compX, compY+=adder), module, FullScope::Y_SCALE_PARAM));
 	addParam(createParam<KnobMini>(Vec(compX, compY+=adder), module, FullScope::ROTATION_PARAM));
 	addParam(createParam<KnobMini>(Vec(compX, compY+=adder), module, FullScope::TIME_PARAM));
+	addParam(createParam<KnobMini>(Vec(compX, compY+=adder), module, FullScope::TRIG_PARAM));
+	addInput(createInput<InPortMini>(Vec(compX, compY+=adder), module, FullScope::TRIG_INPUT));
+	addInput(createInput<InPortMini>(Vec(compX, compY+=adder), module, FullScope::Z_INPUT));
 
 	addChild(createWidget<Logo>(Vec(7, 361)));
 }
@@ -348,12 +1592,86 @@ void FullScopeWidget::step() {
 	ModuleWidget::step();
 }
 
+void FullScopeWidget::onHoverScroll(const event::HoverScroll &e) {
+	FullScope *fullscope = dynamic_cast<FullScope*>(module);
+	if (!fullscope || !fullscope->roll || !fullscope->history) {
+		ModuleWidget::onHoverScroll(e);
+		return;
+	}
+	bool shift = (APP->window->getMods() & RACK_MOD_MASK) == GLFW_MOD_SHIFT;
+	if (e.scrollDelta.x != 0.f)
+		display->scrollRoll(e.scrollDelta.x, true);
+	else
+		display->scrollRoll(e.scrollDelta.y, shift);
+	e.consume(this);
+}
+
 void FullScopeWidget::appendContextMenu(Menu *menu) {
 	FullScope *fullScope = dynamic_cast<FullScope*>(module);
 	assert(fullScope);
 	menu->addChild(new MenuSeparator());
 	menu->addChild(createBoolPtrMenuItem("Lissajous mode", "", &fullScope->lissajous));
 	menu->addChild(createBoolPtrMenuItem("Show statistics", "", &fullScope->showstats));
+	if (fullScope->showstats) {
+		menu->addChild(createIndexPtrSubmenuItem("Statistics time span", {"100 ms", "1 s", "10 s"}, &fullScope->statsSpan));
+		menu->addChild(createBoolPtrMenuItem("Decaying statistics", "", &fullScope->statsDecay));
+		std::vector<std::string> channelLabels;
+		for (int c = 1; c <= PORT_MAX_CHANNELS; c++)
+			channelLabels.push_back(string::f("%d", c));
+		menu->addChild(createIndexPtrSubmenuItem("Statistics channel", channelLabels, &fullScope->statsChannel));
+	}
+	if (fullScope->lissajous) {
+		menu->addChild(createBoolMenuItem("Phosphor density", "",
+			[=]() { return fullScope->density; },
+			[=](bool density) { fullScope->setDensity(density); }
+		));
+		if (fullScope->density)
+			menu->addChild(createIndexPtrSubmenuItem("Persistence", {"100 ms", "500 ms", "2 s"}, &fullScope->persistence));
+		menu->addChild(createBoolPtrMenuItem("3D view", "", &fullScope->view3d));
+		if (fullScope->view3d) {
+			menu->addChild(createIndexPtrSubmenuItem("Camera elevation", {"0°", "15°", "30°", "45°", "60°", "90°"}, &fullScope->elevation));
+			menu->addChild(createIndexPtrSubmenuItem("Perspective", {"None", "Some", "Strong"}, &fullScope->perspective));
+		}
+	}
+	else {
+		menu->addChild(createIndexSubmenuItem("Trigger slope", {"Rising", "Falling"},
+			[=]() { return (size_t) fullScope->triggerFalling; },
+			[=](size_t falling) { fullScope->triggerFalling = falling; }
+		));
+		menu->addChild(createIndexPtrSubmenuItem("Trigger holdoff", {"None", "1 ms", "10 ms", "100 ms", "1 s"}, &fullScope->holdoff));
+		menu->addChild(createIndexPtrSubmenuItem("Before the trigger", {"Nothing", "10%", "25%", "50%"}, &fullScope->pretrigger));
+	}
+	menu->addChild(createBoolMenuItem("Record to disk", "",
+		[=]() { return fullScope->recordState != FullScope::RECORD_IDLE; },
+		[=](bool record) {
+			if (record)
+				fullScope->startRecording();
+			else
+				fullScope->stopRecording();
+		}
+	));
+	menu->addChild(createIndexPtrSubmenuItem("Record as", {"32 bit float WAV", "Raw floats"}, &fullScope->recordFormat));
+	if (fullScope->recorder) {
+		SampleRecorder *recorder = fullScope->recorder.get();
+		menu->addChild(createMenuLabel(recorder->path));
+		if (recorder->failed)
+			menu->addChild(createMenuLabel("Could not write the file"));
+		menu->addChild(createMenuLabel(string::f("Frames dropped: %llu", (unsigned long long) recorder->dropped.load())));
+	}
+	menu->addChild(createBoolMenuItem("Spectrum mode", "",
+		[=]() { return fullScope->spectrum; },
+		[=](bool spectrum) { fullScope->setSpectrum(spectrum); }
+	));
+	menu->addChild(createBoolMenuItem("Roll mode", "",
+		[=]() { return fullScope->roll; },
+		[=](bool roll) { fullScope->setRoll(roll); }
+	));
+	if (fullScope->roll) {
+		FullScopeDisplay *display = this->display;
+		menu->addChild(createMenuItem("Follow the input", "",
+			[=]() { display->rollZoom = 0.f; display->rollEnd = -1; }
+		));
+	}
 }
 
 Model *modelFullScope = createModel<FullScope, FullScopeWidget>("fullscope");
@@ -0,0 +1,116 @@
+// lock-free handoffs between the engine thread and other threads, no Rack
+// involved so the benchmarks can use them too
+
+#pragma once
+#include <stddef.h>
+#include <atomic>
+
+// single producer, single consumer ring of SIZE slots, SIZE a power of two.
+// small messages go through push() and pop(), large ones are written and
+// read in place through the slot calls, so nothing is copied twice. the
+// indices are a cache line apart, so the two threads only share a line when
+// one of them actually hands something over
+template <typename T, size_t SIZE>
+struct SpscRing {
+	static_assert((SIZE & (SIZE - 1)) == 0, "ring size must be a power of two");
+
+	T slots[SIZE];
+	std::atomic<size_t> head; // next slot to write, producer owned
+	char padding[64];
+	std::atomic<size_t> tail; // next slot to read, consumer owned
+
+	SpscRing() : head(0), tail(0) {}
+
+	// filled slots, from either side. the other side may have moved on since
+	size_t size() const {
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+
+	// only while neither side is using the ring
+	void clear() {
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+	}
+
+	// producer side: the free slot to fill, or null when the ring is full
+	T *writeSlot() {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= SIZE)
+			return nullptr;
+		return &slots[h & (SIZE - 1)];
+	}
+
+	void commitWrite() {
+		head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	bool push(const T &value) {
+		T *slot = writeSlot();
+		if (!slot)
+			return false;
+		*slot = value;
+		commitWrite();
+		return true;
+	}
+
+	// consumer side: the oldest filled slot, or null when the ring is empty
+	const T *readSlot() {
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (head.load(std::memory_order_acquire) == t)
+			return nullptr;
+		return &slots[t & (SIZE - 1)];
+	}
+
+	void commitRead() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	bool pop(T &value) {
+		const T *slot = readSlot();
+		if (!slot)
+			return false;
+		value = *slot;
+		commitRead();
+		return true;
+	}
+};
+
+// latest-value handoff of large snapshots: the producer fills one buffer while
+// the consumer reads another, and publishing swaps the filled one into the
+// middle. the consumer only ever sees whole snapshots, older ones it didn't
+// get to are skipped, and neither side copies anything or waits
+template <typename T>
+struct TripleBuffer {
+	static constexpr int INDEX = 3;
+	static constexpr int FRESH = 4; // set on the middle index while unread
+
+	T buffers[3];
+	int back = 0; // producer owned
+	char padding[64];
+	std::atomic<int> middle;
+	char padding2[64];
+	int front = 1; // consumer owned
+
+	TripleBuffer() : middle(2) {}
+
+	// producer side
+	T &write() {
+		return buffers[back];
+	}
+
+	void publish() {
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	// consumer side: moves on to the newest snapshot, true if there was one
+	bool update() {
+		if (!(middle.load(std::memory_order_relaxed) & FRESH))
+			return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+
+	const T &read() const {
+		return buffers[front];
+	}
+};
@@ -0,0 +1,122 @@
+// min/max history of a few signals at ever coarser resolutions, for drawing
+// long stretches of time one min/max pair per pixel column. no Rack involved
+
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include <atomic>
+
+struct MinMaxBucket {
+	float min, max;
+};
+
+// level 0 buckets cover BASE samples and each level above covers twice as
+// many as the one below. every level keeps only its last SIZE buckets in a
+// ring, so memory is fixed while the top level reaches back for days.
+// written one sample at a time on the engine thread. a reader on another
+// thread sees whole buckets through the per level counts, and stays clear of
+// slots about to be rewritten by never reading more than SAFE buckets back
+template <int CHANNELS>
+struct MinMaxPyramid {
+	static constexpr int BASE = 16;
+	static constexpr int LEVELS = 18;
+	static constexpr int SIZE = 4096;
+	static constexpr int SAFE = SIZE / 2;
+
+	MinMaxBucket buckets[LEVELS][SIZE][CHANNELS];
+	std::atomic<int64_t> counts[LEVELS]; // buckets completed on each level
+	MinMaxBucket pending[LEVELS][CHANNELS]; // buckets still being filled
+	int pendingSamples = 0;
+	float sampleRate = 0.f;
+
+	MinMaxPyramid() {
+		clear(0.f);
+	}
+
+	// engine side
+	void clear(float sampleRate) {
+		this->sampleRate = sampleRate;
+		pendingSamples = 0;
+		for (int l = 0; l < LEVELS; l++) {
+			counts[l].store(0, std::memory_order_release);
+			for (int c = 0; c < CHANNELS; c++)
+				pending[l][c] = MinMaxBucket {INFINITY, -INFINITY};
+		}
+	}
+
+	void push(const float *values) {
+		// plain compares, fminf is a libm call unless math is finite-only
+		for (int c = 0; c < CHANNELS; c++) {
+			float v = values[c];
+			pending[0][c].min = v < pending[0][c].min ? v : pending[0][c].min;
+			pending[0][c].max = v > pending[0][c].max ? v : pending[0][c].max;
+		}
+		if (++pendingSamples < BASE)
+			return;
+		pendingSamples = 0;
+
+		// every second bucket completes one on the level above
+		for (int l = 0; l < LEVELS; l++) {
+			int64_t n = counts[l].load(std::memory_order_relaxed);
+			MinMaxBucket *bucket = buckets[l][n & (SIZE - 1)];
+			for (int c = 0; c < CHANNELS; c++) {
+				bucket[c] = pending[l][c];
+				pending[l][c] = MinMaxBucket {INFINITY, -INFINITY};
+			}
+			counts[l].store(n + 1, std::memory_order_release);
+			if (l + 1 == LEVELS)
+				break;
+			for (int c = 0; c < CHANNELS; c++) {
+				MinMaxBucket &above = pending[l + 1][c];
+				above.min = bucket[c].min < above.min ? bucket[c].min : above.min;
+				above.max = bucket[c].max > above.max ? bucket[c].max : above.max;
+			}
+			if (n % 2 == 0)
+				break;
+		}
+	}
+
+	// reader side
+	static int64_t bucketSamples(int level) {
+		return (int64_t) BASE << level;
+	}
+
+	// samples covered by complete level 0 buckets, the newest readable point
+	int64_t end() const {
+		return counts[0].load(std::memory_order_acquire) * BASE;
+	}
+
+	// min and max of one channel over the samples from start to end, from
+	// the level's buckets that lie wholly or partly inside. false if none of
+	// them can be read, because they are too new, too old or overwritten
+	bool range(int level, int64_t start, int64_t end, int channel, MinMaxBucket &out) const {
+		int64_t size = bucketSamples(level);
+		int64_t count = counts[level].load(std::memory_order_acquire);
+		int64_t first = start >= 0 ? start / size : 0;
+		int64_t last = (end + size - 1) / size;
+		if (first < count - SAFE)
+			first = count - SAFE;
+		if (last > count)
+			last = count;
+		if (first >= last)
+			return false;
+		out = MinMaxBucket {INFINITY, -INFINITY};
+		for (int64_t n = first; n < last; n++) {
+			const MinMaxBucket &bucket = buckets[level][n & (SIZE - 1)][channel];
+			out.min = fminf(out.min, bucket.min);
+			out.max = fmaxf(out.max, bucket.max);
+		}
+		return true;
+	}
+
+	// the finest level whose buckets are no longer than the given number of
+	// samples and whose readable buckets still span the given time
+	int level(float samplesPerBucket, float span) const {
+		int l = 0;
+		while (l + 1 < LEVELS && bucketSamples(l + 1) <= samplesPerBucket)
+			l++;
+		while (l + 1 < LEVELS && bucketSamples(l) * (float) SAFE < span)
+			l++;
+		return l;
+	}
+};
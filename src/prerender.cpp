@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "attractor-lfo.hpp"
+
+// one background thread for all modules that render ahead or share engines.
+// it sleeps until a module wakes it, when its lookahead runs low or it wants
+// an engine, and then tops up every job. sleep timers are far too coarse on
+// some systems to poll with, a few ms on Windows. the timeout only catches
+// the odd job that didn't ask. jobs are only added and removed from the ui
+// thread, the engine thread never touches the jobs lock
+struct PrerenderWorker {
+	static constexpr int IDLE_MS = 20;
+
+	std::mutex mutex;
+	std::vector<PrerenderJob*> jobs;
+	std::atomic<bool> running;
+	std::thread thread;
+
+	// set by the first wake-up since the worker last started a pass
+	std::atomic<bool> woken;
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+
+	PrerenderWorker() : running(true), woken(false) {
+		thread = std::thread([this]() { run(); });
+	}
+
+	~PrerenderWorker() {
+		running = false;
+		wake();
+		thread.join();
+	}
+
+	void run() {
+		while (running) {
+			woken.store(false);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (PrerenderJob *job : jobs)
+					job->run(job);
+			}
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wakeCondition.wait_for(lock, std::chrono::milliseconds(IDLE_MS), [this]() { return woken.load(); });
+		}
+	}
+
+	// the worker only holds wakeMutex while it checks the flag, so an engine
+	// thread passing through it never waits on a job pass. passing through
+	// after setting the flag makes sure the worker is either past its check
+	// or already waiting for the notification
+	void wake() {
+		if (woken.exchange(true))
+			return;
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+		}
+		wakeCondition.notify_one();
+	}
+};
+
+static PrerenderWorker &getWorker() {
+	// started by the first module that asks for it
+	static PrerenderWorker worker;
+	return worker;
+}
+
+void addPrerenderJob(PrerenderJob *job) {
+	PrerenderWorker &worker = getWorker();
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	if (std::find(worker.jobs.begin(), worker.jobs.end(), job) == worker.jobs.end())
+		worker.jobs.push_back(job);
+}
+
+void wakePrerenderWorker() {
+	getWorker().wake();
+}
+
+// blocks while the worker is in the middle of the job
+void removePrerenderJob(PrerenderJob *job) {
+	PrerenderWorker &worker = getWorker();
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	worker.jobs.erase(std::remove(worker.jobs.begin(), worker.jobs.end(), job), worker.jobs.end());
+}
@@ -0,0 +1,150 @@
+#include <string.h>
+#include <chrono>
+#include "recorder.hpp"
+
+// the writer wakes up this often. at 48 kHz that's a few blocks of a stereo
+// pair, far from filling the ring
+static const int WRITER_PERIOD_MS = 10;
+// stdio gathers blocks into writes this large
+static const size_t WRITE_BUFFER = 1 << 20;
+// wav headers, up to the samples. mono and stereo files are plain ieee
+// float with an empty extension and a fact chunk, more channels need the
+// extensible format to say which is which
+static const int WAV_HEADER = 58;
+static const int WAV_EXTENSIBLE_HEADER = 80;
+// wav sizes are 32 bit, and the riff size counts the header too
+static const uint64_t WAV_LIMIT = 0xffffffffull - WAV_EXTENSIBLE_HEADER;
+
+bool SampleRecorder::start(const std::string &path, Format format, int channels, int sampleRate) {
+	this->path = path;
+	this->format = format;
+	this->channels = channels;
+	this->sampleRate = sampleRate;
+	blockFrames = BLOCK_SAMPLES / channels;
+	part = 1;
+	if (!openFile())
+		return false;
+	thread = std::thread([this]() { run(); });
+	return true;
+}
+
+void SampleRecorder::finish() {
+	if (thread.joinable())
+		thread.join();
+}
+
+void SampleRecorder::run() {
+	while (true) {
+		// everything pushed before the end is in the ring by now
+		bool done = finished.load(std::memory_order_acquire);
+		while (const Block *b = ring.readSlot()) {
+			writeBlock(*b);
+			ring.commitRead();
+		}
+		if (done)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_PERIOD_MS));
+	}
+	closeFile();
+}
+
+static void putU32(uint8_t *p, uint32_t v) {
+	for (int i = 0; i < 4; i++)
+		p[i] = (v >> (8 * i)) & 0xff;
+}
+
+static void putU16(uint8_t *p, uint16_t v) {
+	p[0] = v & 0xff;
+	p[1] = v >> 8;
+}
+
+// riff header for 32 bit float samples, with the sizes as far as they're
+// known. returns its length
+static int wavHeader(uint8_t *h, int channels, int sampleRate, uint64_t dataBytes) {
+	// ieee float as the extensible subformat
+	static const uint8_t IEEE_FLOAT_GUID[16] = {
+		0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+	};
+	bool extensible = channels > 2;
+	int fmtBytes = extensible ? 40 : 18;
+	int length = extensible ? WAV_EXTENSIBLE_HEADER : WAV_HEADER;
+	memcpy(h, "RIFF", 4);
+	putU32(h + 4, (uint32_t) (length - 8 + dataBytes));
+	memcpy(h + 8, "WAVEfmt ", 8);
+	putU32(h + 16, fmtBytes);
+	putU16(h + 20, extensible ? 0xfffe : 3);
+	putU16(h + 22, channels);
+	putU32(h + 24, sampleRate);
+	putU32(h + 28, sampleRate * channels * 4);
+	putU16(h + 32, channels * 4);
+	putU16(h + 34, 32);
+	putU16(h + 36, fmtBytes - 18); // extension size
+	uint8_t *p = h + 38;
+	if (extensible) {
+		putU16(p, 32); // valid bits
+		// the first speaker positions in order, none past the 18 there are
+		putU32(p + 2, channels <= 18 ? (1u << channels) - 1 : 0);
+		memcpy(p + 6, IEEE_FLOAT_GUID, 16);
+		p += 22;
+	}
+	memcpy(p, "fact", 4);
+	putU32(p + 4, 4);
+	putU32(p + 8, (uint32_t) (dataBytes / (channels * 4))); // frames
+	memcpy(p + 12, "data", 4);
+	putU32(p + 16, (uint32_t) dataBytes);
+	return length;
+}
+
+// later parts of a wav recording are named -part2, -part3 and so on
+bool SampleRecorder::openFile() {
+	std::string name = path;
+	if (part > 1) {
+		size_t dot = name.rfind('.');
+		std::string number = "-part" + std::to_string(part);
+		name = (dot == std::string::npos) ? name + number : name.substr(0, dot) + number + name.substr(dot);
+	}
+	file = fopen(name.c_str(), "wb");
+	if (!file) {
+		failed = true;
+		return false;
+	}
+	setvbuf(file, NULL, _IOFBF, WRITE_BUFFER);
+	dataBytes = 0;
+	if (format == WAV) {
+		// rewritten with the sizes when the file is closed
+		uint8_t header[WAV_EXTENSIBLE_HEADER];
+		int length = wavHeader(header, channels, sampleRate, 0);
+		fwrite(header, 1, length, file);
+	}
+	return true;
+}
+
+void SampleRecorder::closeFile() {
+	if (!file)
+		return;
+	if (format == WAV) {
+		uint8_t header[WAV_EXTENSIBLE_HEADER];
+		int length = wavHeader(header, channels, sampleRate, dataBytes);
+		fseek(file, 0, SEEK_SET);
+		fwrite(header, 1, length, file);
+	}
+	fclose(file);
+	file = nullptr;
+}
+
+// frames are written as they are in memory, all platforms Rack runs on are
+// little endian
+void SampleRecorder::writeBlock(const Block &b) {
+	size_t bytes = (size_t) b.frames * channels * sizeof(float);
+	if (format == WAV && dataBytes + bytes > WAV_LIMIT) {
+		closeFile();
+		part++;
+		openFile();
+	}
+	if (!file || fwrite(b.samples, 1, bytes, file) != bytes) {
+		failed = true;
+		dropped.fetch_add(b.frames, std::memory_order_relaxed);
+		return;
+	}
+	dataBytes += bytes;
+}
@@ -0,0 +1,100 @@
+// streams interleaved float frames to a wav or raw file on disk, no Rack
+// involved. the engine thread fills blocks in place in a ring and never
+// waits; a writer thread of the recorder's own empties the ring every few
+// milliseconds and writes whole blocks through a large stdio buffer. memory
+// stays the same however long the recording runs
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "lockfree.hpp"
+
+struct SampleRecorder {
+	static constexpr int BLOCK_SAMPLES = 4096;
+	// 2 MB, over five seconds of a stereo pair at 48 kHz, a third of a
+	// second of two full poly cables, for the disk to fall behind by
+	static constexpr int BLOCKS = 128;
+
+	enum Format {
+		WAV, // 32 bit float, a new numbered file every 4 GB
+		RAW, // bare little endian floats, no limit
+	};
+
+	struct Block {
+		float samples[BLOCK_SAMPLES];
+		int frames;
+	};
+
+	SpscRing<Block, BLOCKS> ring;
+	std::atomic<uint64_t> dropped; // frames lost to a full ring
+	std::atomic<bool> finished; // the engine pushes no more
+
+	// fixed for a recording
+	std::string path;
+	Format format = WAV;
+	int channels = 0;
+	int sampleRate = 0;
+	int blockFrames = 0;
+
+	// engine side
+	Block *block = nullptr;
+
+	// writer side
+	std::thread thread;
+	FILE *file = nullptr;
+	uint64_t dataBytes = 0; // in the current file
+	int part = 1;
+	std::atomic<bool> failed; // a write went wrong, the rest is dropped
+
+	SampleRecorder() : dropped(0), finished(false), failed(false) {}
+
+	// ends a recording still in progress, the engine must be done with it
+	~SampleRecorder() {
+		end();
+		finish();
+	}
+
+	// ui side: opens the file and starts the writer, false if it can't be
+	// created. frames are channels floats, in whatever order the caller likes
+	bool start(const std::string &path, Format format, int channels, int sampleRate);
+	// waits for the writer to write the rest and close the file, after end()
+	void finish();
+
+	// engine side: room for the next frame, or null when the writer has
+	// fallen so far behind that the ring is full and the frame is dropped
+	float *frame() {
+		if (!block) {
+			block = ring.writeSlot();
+			if (!block) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			block->frames = 0;
+		}
+		return &block->samples[block->frames * channels];
+	}
+
+	void commitFrame() {
+		if (++block->frames == blockFrames) {
+			ring.commitWrite();
+			block = nullptr;
+		}
+	}
+
+	// hands over the partly filled block too, nothing is pushed after this
+	void end() {
+		if (block && block->frames > 0)
+			ring.commitWrite();
+		block = nullptr;
+		finished.store(true, std::memory_order_release);
+	}
+
+	// writer side
+	void run();
+	bool openFile();
+	void closeFile();
+	void writeBlock(const Block &b);
+};
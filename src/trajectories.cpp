@@ -0,0 +1,58 @@
+#include "attractor-lfo.hpp"
+
+#if defined ARCH_WIN
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+// res/trajectories.bin mapped read-only, once per process, so every module
+// instance reads the same pages. it stays mapped until rack exits
+struct MappedFile {
+	const void *data = nullptr;
+	size_t size = 0;
+
+	MappedFile(const std::string &path) {
+#if defined ARCH_WIN
+		HANDLE file = CreateFileW(string::UTF8toUTF16(path).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+			HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping) {
+				data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				size = data ? (size_t) fileSize.QuadPart : 0;
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0) {
+			void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				data = p;
+				size = st.st_size;
+			}
+		}
+		close(fd);
+#endif
+		if (!data)
+			WARN("could not map %s", path.c_str());
+	}
+};
+
+bool loadTrajectoryTable(const char *name, TrajectoryTable &table) {
+	// thread-safe first use, whichever module gets here first
+	static MappedFile file(asset::plugin(pluginInstance, "res/trajectories.bin"));
+	return table.open(file.data, file.size, name);
+}
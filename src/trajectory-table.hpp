@@ -0,0 +1,96 @@
+// precomputed attractor trajectories, rendered offline by
+// tools/render-trajectories.cpp into res/trajectories.bin.
+// layout: a TrajectoryFileHeader, one TrajectoryEntry per attractor, then each
+// attractor's frames as int16 x, y, z, shape grid point after grid point.
+// every table loops, so playback only has to wrap its phase
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+static const char TRAJECTORY_MAGIC[4] = {'W', 'Q', 'T', 'J'};
+static const uint32_t TRAJECTORY_VERSION = 1;
+
+struct TrajectoryFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t attractors;
+	uint32_t shapes; // grid points across each attractor's shape range
+	uint32_t frames; // frames per loop
+};
+
+struct TrajectoryEntry {
+	char name[16];
+	float shapeMin, shapeMax;
+	float timeStep; // attractor time between frames
+	float center[3], scale[3]; // value = center + scale * sample
+	uint32_t offset; // bytes from the start of the file to the first frame
+};
+
+// read-only view on one attractor's tables, over memory owned elsewhere
+struct TrajectoryTable {
+	const TrajectoryEntry *entry = nullptr;
+	const int16_t *data = nullptr;
+	int shapes = 0;
+	int frames = 0;
+
+	// finds an attractor in a whole file, checking the header and bounds
+	bool open(const void *file, size_t size, const char *name) {
+		const TrajectoryFileHeader *header = (const TrajectoryFileHeader*) file;
+		if (!file || size < sizeof(TrajectoryFileHeader)
+			|| memcmp(header->magic, TRAJECTORY_MAGIC, 4) != 0
+			|| header->version != TRAJECTORY_VERSION
+			|| header->shapes < 2 || header->frames < 4
+			|| size < sizeof(TrajectoryFileHeader) + header->attractors * sizeof(TrajectoryEntry))
+			return false;
+		const TrajectoryEntry *entries = (const TrajectoryEntry*) (header + 1);
+		size_t tableSize = (size_t) header->shapes * header->frames * 3 * sizeof(int16_t);
+		for (uint32_t i = 0; i < header->attractors; i++) {
+			if (strncmp(entries[i].name, name, sizeof(entries[i].name)) != 0)
+				continue;
+			if (entries[i].offset % sizeof(int16_t) != 0 || entries[i].offset + tableSize > size)
+				return false;
+			entry = &entries[i];
+			data = (const int16_t*) ((const char*) file + entries[i].offset);
+			shapes = header->shapes;
+			frames = header->frames;
+			return true;
+		}
+		return false;
+	}
+
+	// position of a shape value on the grid, clamped to the rendered range
+	float shapePosition(float shape) const {
+		float s = (shape - entry->shapeMin) / (entry->shapeMax - entry->shapeMin) * (shapes - 1);
+		return s < 0.f ? 0.f : (s > shapes - 1 ? (float) (shapes - 1) : s);
+	}
+
+	// catmull-rom segment from frame to frame + 1 as polynomial coefficients,
+	// value = ((c[3] t + c[2]) t + c[1]) t + c[0] for t in [0, 1), blended
+	// linearly between the two neighbouring shape grid points. trajectories
+	// of neighbouring shapes aren't in step, so a shape between grid points
+	// gives a blend of two orbits rather than the orbit in between
+	void segment(float shapePos, int frame, float coef[3][4]) const {
+		int s0 = (int) shapePos;
+		int s1 = (s0 + 1 < shapes) ? s0 + 1 : s0;
+		float sf = shapePos - s0;
+		int i1 = frame;
+		int i0 = (i1 > 0) ? i1 - 1 : frames - 1;
+		int i2 = (i1 + 1 < frames) ? i1 + 1 : 0;
+		int i3 = (i2 + 1 < frames) ? i2 + 1 : 0;
+		const int16_t *f0 = data + (size_t) s0 * frames * 3;
+		const int16_t *f1 = data + (size_t) s1 * frames * 3;
+		for (int k = 0; k < 3; k++) {
+			float p[4];
+			const int i[4] = {i0, i1, i2, i3};
+			for (int j = 0; j < 4; j++) {
+				float a = f0[i[j] * 3 + k];
+				p[j] = (a + (f1[i[j] * 3 + k] - a) * sf) * entry->scale[k];
+			}
+			coef[k][0] = p[1] + entry->center[k];
+			coef[k][1] = 0.5f * (p[2] - p[0]);
+			coef[k][2] = p[0] - 2.5f * p[1] + 2.f * p[2] - 0.5f * p[3];
+			coef[k][3] = 0.5f * (p[3] - p[0]) + 1.5f * (p[1] - p[2]);
+		}
+	}
+};
@@ -0,0 +1,166 @@
+// renders res/trajectories.bin for the lfo playback mode, see src/trajectory-table.hpp.
+// every attractor runs with rk4 in double precision across a grid of shape
+// values, sampled at about FRAMES_PER_ORBIT frames per turn around the attractor
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "anomalous-math.hpp"
+#include "trajectory-table.hpp"
+
+static const int SHAPES = 8;
+static const int FRAMES = 4096;
+static const int FADE_FRAMES = 256; // crossfade that closes each loop
+static const int FRAMES_PER_ORBIT = 32;
+static const int SUBSTEPS = 32; // rk4 steps per frame
+static const double WARMUP_TIME = 200.0; // attractor time to settle onto the attractor
+static const int MAX_NUDGES = 20; // 1% steps into a shape range that diverges
+
+struct Table {
+	std::vector<float> frames; // x, y, z interleaved
+};
+
+template <template <typename> class TAttractor>
+struct Renderer {
+	float shapeMin, shapeMax;
+
+	// mean time between peaks of x at the default shape, roughly one turn
+	// around the attractor (or around one lobe of it)
+	double orbitTime() {
+		TAttractor<double> a;
+		const double h = 1e-3;
+		for (double t = 0.0; t < WARMUP_TIME; t += h)
+			Rk4Integrator::step(a, a.x, a.y, a.z, h);
+		double x0 = a.x, x1 = a.x;
+		int peaks = 0;
+		for (double t = 0.0; t < WARMUP_TIME; t += h) {
+			Rk4Integrator::step(a, a.x, a.y, a.z, h);
+			peaks += (x1 > x0 && x1 >= a.x);
+			x0 = x1;
+			x1 = a.x;
+		}
+		return WARMUP_TIME / std::max(peaks, 1);
+	}
+
+	// a loop of FRAMES frames, with the last FADE_FRAMES blended into the
+	// ones leading up to the first frame so the wrap is continuous
+	bool renderTable(double shape, double timeStep, Table &table) {
+		TAttractor<double> a;
+		a.shape() = shape;
+		double h = timeStep / SUBSTEPS;
+		for (double t = 0.0; t < WARMUP_TIME; t += h)
+			Rk4Integrator::step(a, a.x, a.y, a.z, h);
+		std::vector<double> run;
+		for (int i = 0; i < FRAMES + FADE_FRAMES; i++) {
+			run.push_back(a.x);
+			run.push_back(a.y);
+			run.push_back(a.z);
+			for (int s = 0; s < SUBSTEPS; s++)
+				Rk4Integrator::step(a, a.x, a.y, a.z, h);
+			if (!std::isfinite(a.x + a.y + a.z))
+				return false;
+		}
+		// run[0, FADE_FRAMES) is the lead-in to the loop's first frame
+		table.frames.resize(FRAMES * 3);
+		for (int i = 0; i < FRAMES; i++) {
+			for (int k = 0; k < 3; k++) {
+				double v = run[(FADE_FRAMES + i) * 3 + k];
+				int fade = i - (FRAMES - FADE_FRAMES);
+				if (fade >= 0) {
+					double w = (fade + 1.0) / (FADE_FRAMES + 1.0);
+					v += (run[fade * 3 + k] - v) * w;
+				}
+				table.frames[i * 3 + k] = v;
+			}
+		}
+		return true;
+	}
+
+	bool render(TrajectoryEntry &entry, std::vector<int16_t> &data) {
+		const char *name = TAttractor<double>::name();
+		double timeStep = orbitTime() / FRAMES_PER_ORBIT;
+		std::vector<Table> tables(SHAPES);
+
+		// some knob ranges reach past where the attractor stays bounded,
+		// narrow them until the end points render and let playback clamp
+		float nudge = (shapeMax - shapeMin) * 0.01f;
+		for (int i = 0; i < MAX_NUDGES && !renderTable(shapeMin, timeStep, tables[0]); i++)
+			shapeMin += nudge;
+		for (int i = 0; i < MAX_NUDGES && !renderTable(shapeMax, timeStep, tables[SHAPES - 1]); i++)
+			shapeMax -= nudge;
+		for (int s = 0; s < SHAPES; s++) {
+			double shape = shapeMin + (shapeMax - shapeMin) * s / (SHAPES - 1);
+			if (!renderTable(shape, timeStep, tables[s])) {
+				fprintf(stderr, "%s diverges at shape %g\n", name, shape);
+				return false;
+			}
+		}
+
+		// one quantization range per coordinate across all shapes, so blending
+		// between grid points works on the samples directly
+		float lo[3] = {INFINITY, INFINITY, INFINITY};
+		float hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+		for (const Table &table : tables) {
+			for (int i = 0; i < FRAMES * 3; i++) {
+				lo[i % 3] = std::min(lo[i % 3], table.frames[i]);
+				hi[i % 3] = std::max(hi[i % 3], table.frames[i]);
+			}
+		}
+		memset(&entry, 0, sizeof(entry));
+		strncpy(entry.name, name, sizeof(entry.name) - 1);
+		entry.shapeMin = shapeMin;
+		entry.shapeMax = shapeMax;
+		entry.timeStep = timeStep;
+		for (int k = 0; k < 3; k++) {
+			entry.center[k] = 0.5f * (lo[k] + hi[k]);
+			entry.scale[k] = std::max(0.5f * (hi[k] - lo[k]), 1e-6f) / 32767.f;
+		}
+		for (const Table &table : tables) {
+			for (int i = 0; i < FRAMES * 3; i++)
+				data.push_back((int16_t) lrintf((table.frames[i] - entry.center[i % 3]) / entry.scale[i % 3]));
+		}
+		printf("%-12s shape %g to %g, time step %.4f, loop of %.0f\n", name, shapeMin, shapeMax, timeStep, timeStep * FRAMES);
+		return true;
+	}
+};
+
+int main(int argc, char **argv) {
+	const char *path = (argc > 1) ? argv[1] : "../res/trajectories.bin";
+
+	// shape ranges match the SHAPE_PARAM limits of the modules
+	std::vector<TrajectoryEntry> entries(6);
+	std::vector<int16_t> data;
+	bool ok = Renderer<THalvorsenAttractor>{1.23f, 1.63f}.render(entries[0], data)
+		&& Renderer<TLorenzAttractor>{0.6f, 3.25f}.render(entries[1], data)
+		&& Renderer<TThomasAttractor>{0.08f, 0.23f}.render(entries[2], data)
+		&& Renderer<TSakaryaAttractor>{0.125f, 0.5f}.render(entries[3], data)
+		&& Renderer<TDadrasAttractor>{1.445f, 9.0f}.render(entries[4], data)
+		&& Renderer<TSprottLinzFAttractor>{0.43f, 0.51f}.render(entries[5], data);
+	if (!ok)
+		return 1;
+
+	TrajectoryFileHeader header;
+	memcpy(header.magic, TRAJECTORY_MAGIC, 4);
+	header.version = TRAJECTORY_VERSION;
+	header.attractors = entries.size();
+	header.shapes = SHAPES;
+	header.frames = FRAMES;
+	uint32_t offset = sizeof(header) + entries.size() * sizeof(TrajectoryEntry);
+	for (TrajectoryEntry &entry : entries) {
+		entry.offset = offset;
+		offset += SHAPES * FRAMES * 3 * sizeof(int16_t);
+	}
+
+	FILE *f = fopen(path, "wb");
+	if (!f) {
+		perror(path);
+		return 1;
+	}
+	fwrite(&header, sizeof(header), 1, f);
+	fwrite(entries.data(), sizeof(TrajectoryEntry), entries.size(), f);
+	fwrite(data.data(), sizeof(int16_t), data.size(), f);
+	fclose(f);
+	printf("wrote %s, %u bytes\n", path, offset);
+	return 0;
+}